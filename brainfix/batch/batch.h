@@ -0,0 +1,86 @@
+#ifndef Batch_h_included
+#define Batch_h_included
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iosfwd>
+#include "../preprocessor/ppparser.h"
+#include "../optimizer/optimizer.h"
+#include "../compiler/ccparser.h"
+#include "../interpreter/interpreter.h"
+
+namespace Batch
+{
+
+struct Job                          // one line of the manifest
+{
+    std::vector<std::string>    inputs;     // .bfx files
+    std::string                 output;
+    size_t                      line;       // in the manifest
+    std::string                 error;      // empty unless the line is malformed
+};
+
+struct Settings                     // the same for every job
+{
+    Optimizer::Options  options;
+    Compiler::Target    target;
+    size_t              tapeSize;
+    bool                header;
+    std::string         backend;    // bf, c or asm
+};
+
+    // The steps of every compile, shared by main(), the builder and the
+    // server. generate() writes the Brainfuck code of the optimized program
+    // to code and throws std::string if it doesn't fit on the tape.
+Compiler::Footprint generate(Preprocessor::Parser &prep, Settings const &settings,
+                             Compiler::Context &context, std::ostream &code);
+std::string usage(Compiler::Footprint const &footprint);   // "Tape: <n> cells ..."
+
+    // Writes the output file for the backend, starting with the header if
+    // asked for. Returns the offset of the code in a bf output file.
+size_t write(std::ostream &out, Interpreter::Program const &program, std::string const &code,
+             Compiler::Footprint const &footprint, Settings const &settings);
+
+    // Compiles a program from the functions of its preprocessed files into
+    // the text of the output file. Throws std::string.
+std::string compile(std::vector<Preprocessor::Function> const &functions,
+                    Settings const &settings, Compiler::Footprint &footprint);
+
+    // Compiles many programs at once: every .bfx file is preprocessed only
+    // once, however many jobs include it, and the jobs run on a number of
+    // threads, each with its own Compiler::Context.
+class Builder
+{
+    struct File
+    {
+        std::vector<Preprocessor::Function> functions;
+        std::string                         error;      // empty if it was preprocessed
+    };
+
+    std::vector<Job>                    d_jobs;
+    Settings                            d_settings;
+    std::map<std::string, File>         d_files;        // of all jobs
+
+    public:
+            // Lines of the manifest hold the input files of a job followed
+            // by its output file; # starts a comment. A malformed line
+            // becomes a job that fails.
+        Builder(std::istream &manifest, Settings const &settings);
+
+            // Writes a line for every failed job and a summary to report.
+            // Returns the number of jobs that failed.
+        size_t run(size_t threads, std::ostream &report);
+
+    private:
+        static void preprocess(std::string const &fileName, File &file);
+        void compile(Job const &job) const;                 // throws std::string
+
+            // Calls work(idx) for every idx below count on the threads
+        template <typename Work>
+        static void parallel(size_t count, size_t threads, Work work);
+};
+
+}
+
+#endif
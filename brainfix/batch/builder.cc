@@ -0,0 +1,117 @@
+#include "batch.ih"
+#include <iomanip>
+
+Builder::Builder(istream &manifest, Settings const &settings)
+:
+    d_settings(settings)
+{
+    string text;
+    for (size_t line = 1; getline(manifest, text); ++line)
+    {
+        istringstream words(text.substr(0, text.find('#')));
+        Job job{vector<string>(), "", line, ""};
+        for (string word; words >> word; )
+        {
+            if (!job.output.empty())
+            {
+                job.error = "The output file comes last.";
+                break;
+            }
+
+            size_t pos = word.find_last_of('.');
+            if (pos != string::npos && word.substr(pos) == ".bfx")
+                job.inputs.push_back(word);
+            else
+                job.output = word;
+        }
+
+        if (job.inputs.empty() && job.output.empty())
+            continue;
+        if (job.error.empty() && (job.inputs.empty() || job.output.empty()))
+            job.error = "A job needs .bfx files and an output file.";
+
+        // The files of a malformed line aren't preprocessed
+        if (job.error.empty())
+            for (string const &input: job.inputs)
+                d_files[input];
+        d_jobs.push_back(job);
+    }
+}
+
+size_t Builder::run(size_t threads, ostream &report)
+{
+    auto started = chrono::steady_clock::now();
+
+    // 1. Preprocess every file once: the map itself doesn't change anymore
+    vector<pair<string const, File> *> files;
+    for (auto &file: d_files)
+        files.push_back(&file);
+    parallel(files.size(), threads, [&](size_t idx)
+    {
+        preprocess(files[idx]->first, files[idx]->second);
+    });
+
+    // 2. Compile the jobs, each in its own Context
+    vector<string> errors(d_jobs.size());
+    vector<double> seconds(d_jobs.size());
+    parallel(d_jobs.size(), threads, [&](size_t idx)
+    {
+        auto start = chrono::steady_clock::now();
+        try
+        {
+            compile(d_jobs[idx]);
+        }
+        catch (string const &msg)
+        {
+            errors[idx] = msg;
+        }
+        catch (exception const &exc)
+        {
+            errors[idx] = exc.what();
+        }
+        seconds[idx] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    });
+
+    size_t failed = 0;
+    size_t slowest = 0;
+    double total = 0;
+    for (size_t idx = 0; idx != d_jobs.size(); ++idx)
+    {
+        total += seconds[idx];
+        if (seconds[idx] > seconds[slowest])
+            slowest = idx;
+        if (errors[idx].empty())
+            continue;
+
+        ++failed;
+        report << (d_jobs[idx].output.empty() ? "-" : d_jobs[idx].output)
+               << " (manifest line " << d_jobs[idx].line << "): " << errors[idx] << '\n';
+    }
+
+    chrono::duration<double> wall = chrono::steady_clock::now() - started;
+    report << d_jobs.size() - failed << " of " << d_jobs.size() << " jobs compiled from "
+           << d_files.size() << " files in " << fixed << setprecision(3) << wall.count()
+           << "s on " << threads << (threads == 1 ? " thread, " : " threads, ") << total 
+           << "s in the jobs";
+    if (!d_jobs.empty())
+        report << ", slowest " << d_jobs[slowest].output << ' ' << seconds[slowest] << 's';
+    report << '\n';
+
+    return failed;
+}
+
+void Builder::preprocess(string const &fileName, File &file)
+{
+    ifstream in(fileName);
+    if (!in)
+    {
+        file.error = "Can't open " + fileName + ".";
+        return;
+    }
+
+    Preprocessor::Parser parser;
+    if (parser.parse(in, fileName) != 0)
+        file.error = "Syntax error in " + fileName + ".";
+    else
+        file.functions = parser.functions();
+}
@@ -0,0 +1,53 @@
+#include "batch.ih"
+
+void Builder::compile(Job const &job) const
+{
+    if (!job.error.empty())
+        throw job.error;
+
+    vector<Preprocessor::Function> functions;
+    for (string const &input: job.inputs)
+    {
+        File const &file = d_files.find(input)->second;
+        if (!file.error.empty())
+            throw file.error;
+        functions.insert(functions.end(), file.functions.begin(), file.functions.end());
+    }
+
+    Compiler::Footprint footprint;
+    string output = Batch::compile(functions, d_settings, footprint);
+    ofstream out(job.output);
+    if (!out)
+        throw "Can't write " + job.output + ".";
+    out << output;
+}
+
+string Batch::compile(vector<Preprocessor::Function> const &functions, Settings const &settings,
+                      Compiler::Footprint &footprint)
+{
+    Preprocessor::Parser prep;
+    prep.functions() = functions;
+    Optimizer::optimize(prep, settings.options);
+
+    Compiler::Context context(settings.tapeSize, settings.target);
+    ostringstream code;
+    footprint = generate(prep, settings, context, code);
+
+    Interpreter::Program program(code.str(), settings.target.cellBits, settings.target.wrap);
+    ostringstream out;
+    write(out, program, code.str(), footprint, settings);
+    return out.str();
+}
+
+Compiler::Footprint Batch::generate(Preprocessor::Parser &prep, Settings const &settings,
+                                    Compiler::Context &context, ostream &code)
+{
+    Compiler::Footprint footprint = Compiler::Parser::compile(context, prep, code,
+        Optimizer::CallGraph(prep.functions(), settings.options.shareBudget));
+
+    if (footprint.cells > settings.tapeSize)
+        throw string("Error: the program needs ") + to_string(footprint.cells) +
+              " cells, but the tape has only " + to_string(settings.tapeSize) + ".";
+
+    return footprint;
+}
@@ -0,0 +1,45 @@
+#include "batch.ih"
+
+string Batch::usage(Compiler::Footprint const &footprint)
+{
+    // No Brainfuck commands in here: it's also used as a comment
+    ostringstream out;
+    out << "Tape: " << footprint.cells << " cells";
+    if (!footprint.bounded)
+        out << " and two more for every value on the recursion stack";
+
+    return out.str();
+}
+
+size_t Batch::write(ostream &out, Interpreter::Program const &program, string const &code,
+                    Compiler::Footprint const &footprint, Settings const &settings)
+{
+    ostringstream description;
+    description << "Generated by BrainFix for " << settings.target.cellBits << " bit cells that "
+                << (settings.target.wrap ? "wrap around" : "stop at zero") << '\n'
+                << usage(footprint) << '\n';
+
+    if (settings.backend == "c")
+    {
+        if (settings.header)
+            out << "/*\n" << description.str() << "*/\n\n";
+        program.writeC(out, settings.tapeSize);
+        return 0;
+    }
+
+    if (settings.backend == "asm")
+    {
+        istringstream lines(description.str());
+        string line;
+        while (settings.header && getline(lines, line))
+            out << "# " << line << '\n';
+        program.writeAsm(out, settings.tapeSize);
+        return 0;
+    }
+
+    if (settings.header)
+        out << description.str() << '\n';
+    size_t start = out.tellp();
+    out << code;
+    return start;
+}
@@ -187,14 +187,14 @@ PI__ const s_productionInfo[] =
 // State info and SR__ transitions for each state.
 
 
-SR__ s_0[] =
+SR__ const s_0[] =
 {
     { { DEF_RED}, {  2} },             
     { {     290}, {  1} }, // stmt_list
     { {       0}, { -1} },             
 };
 
-SR__ s_1[] =
+SR__ const s_1[] =
 {
     { { REQ_TOKEN}, {           31} },             
     { {       291}, {            2} }, // stmt     
@@ -230,44 +230,44 @@ SR__ s_1[] =
     { {         0}, {            0} },             
 };
 
-SR__ s_2[] =
+SR__ const s_2[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -2} }, 
 };
 
-SR__ s_3[] =
+SR__ const s_3[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -3} }, 
 };
 
-SR__ s_4[] =
+SR__ const s_4[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -4} }, 
 };
 
-SR__ s_5[] =
+SR__ const s_5[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -5} }, 
 };
 
-SR__ s_6[] =
+SR__ const s_6[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -6} }, 
 };
 
-SR__ s_7[] =
+SR__ const s_7[] =
 {
     { { DEF_RED}, {  2} },             
     { {     290}, { 31} }, // stmt_list
     { {       0}, { -1} },             
 };
 
-SR__ s_8[] =
+SR__ const s_8[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 32} }, // expr     
@@ -288,7 +288,7 @@ SR__ s_8[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_9[] =
+SR__ const s_9[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 33} }, // expr     
@@ -309,7 +309,7 @@ SR__ s_9[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_10[] =
+SR__ const s_10[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 34} }, // expr     
@@ -330,7 +330,7 @@ SR__ s_10[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_11[] =
+SR__ const s_11[] =
 {
     { { REQ_TOKEN}, {  3} },          
     { {       302}, { 35} }, // lvalue
@@ -338,7 +338,7 @@ SR__ s_11[] =
     { {         0}, {  0} },          
 };
 
-SR__ s_12[] =
+SR__ const s_12[] =
 {
     { { REQ_TOKEN}, { 15} },       
     { {        59}, { 36} }, // ';'
@@ -358,7 +358,7 @@ SR__ s_12[] =
     { {         0}, {  0} },       
 };
 
-SR__ s_13[] =
+SR__ const s_13[] =
 {
     { { REQ_TOKEN}, { 30} },             
     { {       291}, { 50} }, // stmt     
@@ -393,7 +393,7 @@ SR__ s_13[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_14[] =
+SR__ const s_14[] =
 {
     { { REQ_TOKEN}, { 30} },             
     { {       291}, { 51} }, // stmt     
@@ -428,7 +428,7 @@ SR__ s_14[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_15[] =
+SR__ const s_15[] =
 {
     { { REQ_DEF}, {   9} },         
     { {      61}, {  52} }, // '='  
@@ -442,13 +442,13 @@ SR__ s_15[] =
     { {       0}, { -38} },         
 };
 
-SR__ s_16[] =
+SR__ const s_16[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -39} }, 
 };
 
-SR__ s_17[] =
+SR__ const s_17[] =
 {
     { { REQ_DEF}, {   7} },       
     { {      61}, {  60} }, // '='
@@ -460,7 +460,7 @@ SR__ s_17[] =
     { {       0}, { -29} },       
 };
 
-SR__ s_18[] =
+SR__ const s_18[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 66} }, // expr     
@@ -481,7 +481,7 @@ SR__ s_18[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_19[] =
+SR__ const s_19[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 67} }, // expr     
@@ -502,7 +502,7 @@ SR__ s_19[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_20[] =
+SR__ const s_20[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 68} }, // expr     
@@ -523,7 +523,7 @@ SR__ s_20[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_21[] =
+SR__ const s_21[] =
 {
     { { REQ_TOKEN}, {  3} },          
     { {       302}, { 69} }, // lvalue
@@ -531,31 +531,31 @@ SR__ s_21[] =
     { {         0}, {  0} },          
 };
 
-SR__ s_22[] =
+SR__ const s_22[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -31} }, 
 };
 
-SR__ s_23[] =
+SR__ const s_23[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -24} }, 
 };
 
-SR__ s_24[] =
+SR__ const s_24[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -25} }, 
 };
 
-SR__ s_25[] =
+SR__ const s_25[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -26} }, 
 };
 
-SR__ s_26[] =
+SR__ const s_26[] =
 {
     { { REQ_DEF}, {  18} },             
     { {     299}, {  70} }, // opt_list 
@@ -578,33 +578,33 @@ SR__ s_26[] =
     { {       0}, { -21} },             
 };
 
-SR__ s_27[] =
+SR__ const s_27[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -28} }, 
 };
 
-SR__ s_28[] =
+SR__ const s_28[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -30} }, 
 };
 
-SR__ s_29[] =
+SR__ const s_29[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {        40}, { 73} }, // '('
     { {         0}, {  0} },       
 };
 
-SR__ s_30[] =
+SR__ const s_30[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {       260}, { 74} }, // CST
     { {         0}, {  0} },       
 };
 
-SR__ s_31[] =
+SR__ const s_31[] =
 {
     { { REQ_TOKEN}, { 31} },             
     { {       125}, { 75} }, // '}'      
@@ -640,7 +640,7 @@ SR__ s_31[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_32[] =
+SR__ const s_32[] =
 {
     { { REQ_TOKEN}, { 15} },       
     { {        59}, { 76} }, // ';'
@@ -660,7 +660,7 @@ SR__ s_32[] =
     { {         0}, {  0} },       
 };
 
-SR__ s_33[] =
+SR__ const s_33[] =
 {
     { { REQ_TOKEN}, { 15} },       
     { {        59}, { 77} }, // ';'
@@ -680,7 +680,7 @@ SR__ s_33[] =
     { {         0}, {  0} },       
 };
 
-SR__ s_34[] =
+SR__ const s_34[] =
 {
     { { REQ_TOKEN}, { 15} },       
     { {        59}, { 78} }, // ';'
@@ -700,20 +700,20 @@ SR__ s_34[] =
     { {         0}, {  0} },       
 };
 
-SR__ s_35[] =
+SR__ const s_35[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {        59}, { 79} }, // ';'
     { {         0}, {  0} },       
 };
 
-SR__ s_36[] =
+SR__ const s_36[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -8} }, 
 };
 
-SR__ s_37[] =
+SR__ const s_37[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 80} }, // expr     
@@ -734,7 +734,7 @@ SR__ s_37[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_38[] =
+SR__ const s_38[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 81} }, // expr     
@@ -755,7 +755,7 @@ SR__ s_38[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_39[] =
+SR__ const s_39[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 82} }, // expr     
@@ -776,7 +776,7 @@ SR__ s_39[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_40[] =
+SR__ const s_40[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 83} }, // expr     
@@ -797,7 +797,7 @@ SR__ s_40[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_41[] =
+SR__ const s_41[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 84} }, // expr     
@@ -818,7 +818,7 @@ SR__ s_41[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_42[] =
+SR__ const s_42[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 85} }, // expr     
@@ -839,7 +839,7 @@ SR__ s_42[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_43[] =
+SR__ const s_43[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 86} }, // expr     
@@ -860,7 +860,7 @@ SR__ s_43[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_44[] =
+SR__ const s_44[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 87} }, // expr     
@@ -881,7 +881,7 @@ SR__ s_44[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_45[] =
+SR__ const s_45[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 88} }, // expr     
@@ -902,7 +902,7 @@ SR__ s_45[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_46[] =
+SR__ const s_46[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 89} }, // expr     
@@ -923,7 +923,7 @@ SR__ s_46[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_47[] =
+SR__ const s_47[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 90} }, // expr     
@@ -944,7 +944,7 @@ SR__ s_47[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_48[] =
+SR__ const s_48[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 91} }, // expr     
@@ -965,7 +965,7 @@ SR__ s_48[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_49[] =
+SR__ const s_49[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 92} }, // expr     
@@ -986,7 +986,7 @@ SR__ s_49[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_50[] =
+SR__ const s_50[] =
 {
     { { REQ_DEF}, {   3} },        
     { {     297}, {  93} }, // else
@@ -994,13 +994,13 @@ SR__ s_50[] =
     { {       0}, { -13} },        
 };
 
-SR__ s_51[] =
+SR__ const s_51[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -15} }, 
 };
 
-SR__ s_52[] =
+SR__ const s_52[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 95} }, // expr     
@@ -1021,7 +1021,7 @@ SR__ s_52[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_53[] =
+SR__ const s_53[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 96} }, // expr     
@@ -1042,7 +1042,7 @@ SR__ s_53[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_54[] =
+SR__ const s_54[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 97} }, // expr     
@@ -1063,7 +1063,7 @@ SR__ s_54[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_55[] =
+SR__ const s_55[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 98} }, // expr     
@@ -1084,7 +1084,7 @@ SR__ s_55[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_56[] =
+SR__ const s_56[] =
 {
     { { REQ_TOKEN}, { 16} },             
     { {       307}, { 99} }, // expr     
@@ -1105,7 +1105,7 @@ SR__ s_56[] =
     { {         0}, {  0} },             
 };
 
-SR__ s_57[] =
+SR__ const s_57[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 100} }, // expr     
@@ -1126,13 +1126,13 @@ SR__ s_57[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_58[] =
+SR__ const s_58[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -32} }, 
 };
 
-SR__ s_59[] =
+SR__ const s_59[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 101} }, // expr     
@@ -1153,7 +1153,7 @@ SR__ s_59[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_60[] =
+SR__ const s_60[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 102} }, // expr     
@@ -1174,7 +1174,7 @@ SR__ s_60[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_61[] =
+SR__ const s_61[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 103} }, // expr     
@@ -1195,7 +1195,7 @@ SR__ s_61[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_62[] =
+SR__ const s_62[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 104} }, // expr     
@@ -1216,7 +1216,7 @@ SR__ s_62[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_63[] =
+SR__ const s_63[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 105} }, // expr     
@@ -1237,7 +1237,7 @@ SR__ s_63[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_64[] =
+SR__ const s_64[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 106} }, // expr     
@@ -1258,7 +1258,7 @@ SR__ s_64[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_65[] =
+SR__ const s_65[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 107} }, // expr     
@@ -1279,13 +1279,13 @@ SR__ s_65[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_66[] =
+SR__ const s_66[] =
 {
     { { REQ_DEF}, {   1} }, 
     { {       0}, { -65} }, 
 };
 
-SR__ s_67[] =
+SR__ const s_67[] =
 {
     { { REQ_TOKEN}, {  15} },       
     { {        41}, { 108} }, // ')'
@@ -1305,7 +1305,7 @@ SR__ s_67[] =
     { {         0}, {   0} },       
 };
 
-SR__ s_68[] =
+SR__ const s_68[] =
 {
     { { REQ_DEF}, {  14} },       
     { {      43}, {  37} }, // '+'
@@ -1324,28 +1324,28 @@ SR__ s_68[] =
     { {       0}, { -16} },       
 };
 
-SR__ s_69[] =
+SR__ const s_69[] =
 {
     { { REQ_TOKEN}, {   2} },       
     { {        61}, { 109} }, // '='
     { {         0}, {   0} },       
 };
 
-SR__ s_70[] =
+SR__ const s_70[] =
 {
     { { REQ_TOKEN}, {   2} },       
     { {        93}, { 110} }, // ']'
     { {         0}, {   0} },       
 };
 
-SR__ s_71[] =
+SR__ const s_71[] =
 {
     { { REQ_DEF}, {   2} },       
     { {      44}, { 111} }, // ','
     { {       0}, { -20} },       
 };
 
-SR__ s_72[] =
+SR__ const s_72[] =
 {
     { { REQ_DEF}, {  14} },       
     { {      43}, {  37} }, // '+'
@@ -1364,7 +1364,7 @@ SR__ s_72[] =
     { {       0}, { -22} },       
 };
 
-SR__ s_73[] =
+SR__ const s_73[] =
 {
     { { REQ_DEF}, {  18} },             
     { {     299}, { 112} }, // opt_list 
@@ -1387,7 +1387,7 @@ SR__ s_73[] =
     { {       0}, { -21} },             
 };
 
-SR__ s_74[] =
+SR__ const s_74[] =
 {
     { { REQ_DEF}, {   3} },       
     { {     260}, { 113} }, // CST
@@ -1395,37 +1395,37 @@ SR__ s_74[] =
     { {       0}, { -34} },       
 };
 
-SR__ s_75[] =
+SR__ const s_75[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -7} }, 
 };
 
-SR__ s_76[] =
+SR__ const s_76[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -9} }, 
 };
 
-SR__ s_77[] =
+SR__ const s_77[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -10} }, 
 };
 
-SR__ s_78[] =
+SR__ const s_78[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -11} }, 
 };
 
-SR__ s_79[] =
+SR__ const s_79[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -12} }, 
 };
 
-SR__ s_80[] =
+SR__ const s_80[] =
 {
     { { REQ_DEF}, {   4} },       
     { {      42}, {  39} }, // '*'
@@ -1434,7 +1434,7 @@ SR__ s_80[] =
     { {       0}, { -52} },       
 };
 
-SR__ s_81[] =
+SR__ const s_81[] =
 {
     { { REQ_DEF}, {   4} },       
     { {      42}, {  39} }, // '*'
@@ -1443,25 +1443,25 @@ SR__ s_81[] =
     { {       0}, { -53} },       
 };
 
-SR__ s_82[] =
+SR__ const s_82[] =
 {
     { { REQ_DEF}, {   1} }, 
     { {       0}, { -54} }, 
 };
 
-SR__ s_83[] =
+SR__ const s_83[] =
 {
     { { REQ_DEF}, {   1} }, 
     { {       0}, { -55} }, 
 };
 
-SR__ s_84[] =
+SR__ const s_84[] =
 {
     { { REQ_DEF}, {   1} }, 
     { {       0}, { -56} }, 
 };
 
-SR__ s_85[] =
+SR__ const s_85[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1472,7 +1472,7 @@ SR__ s_85[] =
     { {       0}, { -57} },       
 };
 
-SR__ s_86[] =
+SR__ const s_86[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1483,7 +1483,7 @@ SR__ s_86[] =
     { {       0}, { -58} },       
 };
 
-SR__ s_87[] =
+SR__ const s_87[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1494,7 +1494,7 @@ SR__ s_87[] =
     { {       0}, { -59} },       
 };
 
-SR__ s_88[] =
+SR__ const s_88[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1505,7 +1505,7 @@ SR__ s_88[] =
     { {       0}, { -60} },       
 };
 
-SR__ s_89[] =
+SR__ const s_89[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1516,7 +1516,7 @@ SR__ s_89[] =
     { {       0}, { -61} },       
 };
 
-SR__ s_90[] =
+SR__ const s_90[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1527,7 +1527,7 @@ SR__ s_90[] =
     { {       0}, { -62} },       
 };
 
-SR__ s_91[] =
+SR__ const s_91[] =
 {
     { { REQ_DEF}, {  12} },       
     { {      43}, {  37} }, // '+'
@@ -1544,7 +1544,7 @@ SR__ s_91[] =
     { {       0}, { -63} },       
 };
 
-SR__ s_92[] =
+SR__ const s_92[] =
 {
     { { REQ_DEF}, {  12} },       
     { {      43}, {  37} }, // '+'
@@ -1561,7 +1561,7 @@ SR__ s_92[] =
     { {       0}, { -64} },       
 };
 
-SR__ s_93[] =
+SR__ const s_93[] =
 {
     { { REQ_TOKEN}, {  30} },             
     { {       291}, { 115} }, // stmt     
@@ -1596,13 +1596,13 @@ SR__ s_93[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_94[] =
+SR__ const s_94[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -17} }, 
 };
 
-SR__ s_95[] =
+SR__ const s_95[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1613,7 +1613,7 @@ SR__ s_95[] =
     { {       0}, { -40} },       
 };
 
-SR__ s_96[] =
+SR__ const s_96[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1624,7 +1624,7 @@ SR__ s_96[] =
     { {       0}, { -41} },       
 };
 
-SR__ s_97[] =
+SR__ const s_97[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1635,7 +1635,7 @@ SR__ s_97[] =
     { {       0}, { -42} },       
 };
 
-SR__ s_98[] =
+SR__ const s_98[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1646,7 +1646,7 @@ SR__ s_98[] =
     { {       0}, { -43} },       
 };
 
-SR__ s_99[] =
+SR__ const s_99[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1657,7 +1657,7 @@ SR__ s_99[] =
     { {       0}, { -44} },       
 };
 
-SR__ s_100[] =
+SR__ const s_100[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1668,7 +1668,7 @@ SR__ s_100[] =
     { {       0}, { -45} },       
 };
 
-SR__ s_101[] =
+SR__ const s_101[] =
 {
     { { REQ_TOKEN}, {  15} },       
     { {        93}, { 116} }, // ']'
@@ -1688,7 +1688,7 @@ SR__ s_101[] =
     { {         0}, {   0} },       
 };
 
-SR__ s_102[] =
+SR__ const s_102[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1699,7 +1699,7 @@ SR__ s_102[] =
     { {       0}, { -46} },       
 };
 
-SR__ s_103[] =
+SR__ const s_103[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1710,7 +1710,7 @@ SR__ s_103[] =
     { {       0}, { -47} },       
 };
 
-SR__ s_104[] =
+SR__ const s_104[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1721,7 +1721,7 @@ SR__ s_104[] =
     { {       0}, { -48} },       
 };
 
-SR__ s_105[] =
+SR__ const s_105[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1732,7 +1732,7 @@ SR__ s_105[] =
     { {       0}, { -49} },       
 };
 
-SR__ s_106[] =
+SR__ const s_106[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1743,7 +1743,7 @@ SR__ s_106[] =
     { {       0}, { -50} },       
 };
 
-SR__ s_107[] =
+SR__ const s_107[] =
 {
     { { REQ_DEF}, {   6} },       
     { {      43}, {  37} }, // '+'
@@ -1754,13 +1754,13 @@ SR__ s_107[] =
     { {       0}, { -51} },       
 };
 
-SR__ s_108[] =
+SR__ const s_108[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -66} }, 
 };
 
-SR__ s_109[] =
+SR__ const s_109[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 117} }, // expr     
@@ -1781,13 +1781,13 @@ SR__ s_109[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_110[] =
+SR__ const s_110[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -27} }, 
 };
 
-SR__ s_111[] =
+SR__ const s_111[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 118} }, // expr     
@@ -1808,38 +1808,38 @@ SR__ s_111[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_112[] =
+SR__ const s_112[] =
 {
     { { REQ_TOKEN}, {   2} },       
     { {        41}, { 119} }, // ')'
     { {         0}, {   0} },       
 };
 
-SR__ s_113[] =
+SR__ const s_113[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -35} }, 
 };
 
-SR__ s_114[] =
+SR__ const s_114[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -36} }, 
 };
 
-SR__ s_115[] =
+SR__ const s_115[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -14} }, 
 };
 
-SR__ s_116[] =
+SR__ const s_116[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -33} }, 
 };
 
-SR__ s_117[] =
+SR__ const s_117[] =
 {
     { { REQ_TOKEN}, {  15} },       
     { {        58}, { 120} }, // ':'
@@ -1859,7 +1859,7 @@ SR__ s_117[] =
     { {         0}, {   0} },       
 };
 
-SR__ s_118[] =
+SR__ const s_118[] =
 {
     { { REQ_DEF}, {  14} },       
     { {      43}, {  37} }, // '+'
@@ -1878,13 +1878,13 @@ SR__ s_118[] =
     { {       0}, { -23} },       
 };
 
-SR__ s_119[] =
+SR__ const s_119[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -37} }, 
 };
 
-SR__ s_120[] =
+SR__ const s_120[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 121} }, // expr     
@@ -1905,7 +1905,7 @@ SR__ s_120[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_121[] =
+SR__ const s_121[] =
 {
     { { REQ_DEF}, {  15} },       
     { {      58}, { 122} }, // ':'
@@ -1925,7 +1925,7 @@ SR__ s_121[] =
     { {       0}, { -18} },       
 };
 
-SR__ s_122[] =
+SR__ const s_122[] =
 {
     { { REQ_TOKEN}, {  16} },             
     { {       307}, { 123} }, // expr     
@@ -1946,7 +1946,7 @@ SR__ s_122[] =
     { {         0}, {   0} },             
 };
 
-SR__ s_123[] =
+SR__ const s_123[] =
 {
     { { REQ_DEF}, {  14} },       
     { {      43}, {  37} }, // '+'
@@ -1967,7 +1967,7 @@ SR__ s_123[] =
 
 
 // State array:
-SR__ *s_state[] =
+SR__ const *s_state[] =
 {
   s_0,  s_1,  s_2,  s_3,  s_4,  s_5,  s_6,  s_7,  s_8,  s_9,
   s_10,  s_11,  s_12,  s_13,  s_14,  s_15,  s_16,  s_17,  s_18,  s_19,
@@ -2248,7 +2248,7 @@ void Parser::executeAction(int production)
         case 29:
 #line 194 "grammar"
         {
-         d_val__.get<Tag__::INT>() = arrayValue((d_vsp__[0].data<Tag__::PAIR1>()).first, (d_vsp__[0].data<Tag__::PAIR1>()).second);
+         d_val__.get<Tag__::INT>() = common("[]", (d_vsp__[0].data<Tag__::PAIR1>()).first, (d_vsp__[0].data<Tag__::PAIR1>()).second);
          }
         break;
 
@@ -2395,98 +2395,98 @@ void Parser::executeAction(int production)
         case 52:
 #line 315 "grammar"
         {
-         d_val__.get<Tag__::INT>() = add(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
+         d_val__.get<Tag__::INT>() = common("+", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
          }
         break;
 
         case 53:
 #line 320 "grammar"
         {
-         d_val__.get<Tag__::INT>() = subtract(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
+         d_val__.get<Tag__::INT>() = common("-", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
          }
         break;
 
         case 54:
 #line 325 "grammar"
         {
-         d_val__.get<Tag__::INT>() = multiply(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
+         d_val__.get<Tag__::INT>() = common("*", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
          }
         break;
 
         case 55:
 #line 330 "grammar"
         {
-         d_val__.get<Tag__::INT>() = divide(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
+         d_val__.get<Tag__::INT>() = common("/", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
          }
         break;
 
         case 56:
 #line 335 "grammar"
         {
-         d_val__.get<Tag__::INT>() = modulo(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
+         d_val__.get<Tag__::INT>() = common("%", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>()); 
          }
         break;
 
         case 57:
 #line 340 "grammar"
         {
-         d_val__.get<Tag__::INT>() = lt(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common("<", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
         case 58:
 #line 345 "grammar"
         {
-         d_val__.get<Tag__::INT>() = gt(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common(">", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
         case 59:
 #line 350 "grammar"
         {
-         d_val__.get<Tag__::INT>() = le(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common("<=", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
         case 60:
 #line 355 "grammar"
         {
-         d_val__.get<Tag__::INT>() = ge(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common(">=", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
         case 61:
 #line 360 "grammar"
         {
-         d_val__.get<Tag__::INT>() = eq(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common("==", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
         case 62:
 #line 365 "grammar"
         {
-         d_val__.get<Tag__::INT>() = ne(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common("!=", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
         case 63:
 #line 370 "grammar"
         {
-         d_val__.get<Tag__::INT>() = logicAnd(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common("&&", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
         case 64:
 #line 375 "grammar"
         {
-         d_val__.get<Tag__::INT>() = logicOr(d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common("||", d_vsp__[-2].data<Tag__::INT>(), d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
         case 65:
 #line 380 "grammar"
         {
-         d_val__.get<Tag__::INT>() = logicNot(d_vsp__[0].data<Tag__::INT>());
+         d_val__.get<Tag__::INT>() = common("!", d_vsp__[0].data<Tag__::INT>());
          }
         break;
 
@@ -2535,15 +2535,13 @@ void Parser::nextToken()
 int Parser::lookup(bool recovery)
 {
     // $insert threading
-    SR__ *sr = s_state[d_state__];        // get the appropriate state-table
+    SR__ const *sr = s_state[d_state__];  // get the appropriate state-table
     int lastIdx = sr->d_lastIdx;        // sentinel-index in the SR__ array
 
-    SR__ *lastElementPtr = sr + lastIdx;
-    SR__ *elementPtr = sr + 1;            // start the search at s_xx[1]
+    SR__ const *lastElementPtr = sr + lastIdx;
+    SR__ const *elementPtr = sr + 1;      // start the search at s_xx[1]
 
-    lastElementPtr->d_token = d_token__;// set search-token
-
-    while (elementPtr->d_token != d_token__)
+    while (elementPtr != lastElementPtr && elementPtr->d_token != d_token__)   // patched, see grammar
         ++elementPtr;
 
     if (elementPtr == lastElementPtr)   // reached the last element
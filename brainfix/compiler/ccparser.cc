@@ -1,20 +1,28 @@
 #include "ccparser.ih"
 
-Parser::Parser(Preprocessor::Parser const &preprocessor, string const &funName, ostream &out, vector<int> const &args)
+Parser::Parser(Context &context, Preprocessor::Parser const &preprocessor, string const &funName, ostream &out, vector<int> const &args, bool shared)
 :
+    d_context(context),
     d_preprocessor(preprocessor),
     d_function(d_preprocessor.function(funName)),
     d_out(out),
-    d_streamPtr(0)
+    d_streamPtr(0),
+    d_blockMode(d_context.callGraph.blockMode(d_function.body)),
+    d_control(0),
+    d_elses(Optimizer::elseBranches(d_function.body)),
+    d_liveness(d_function.body),
+    d_statement(0),
+    d_traces(0)
 {
-    if (!s_initialized)
-        throw string("Compiler::Parser class not initialized. Call Compiler::Parser::init() first.");
-    
     // 0. Increment function depth counter
-    s_functionVec.push_back(funName);
-    
-    // 1. Check if arguments match
-    if (args.size() != d_function.args.size())
+    d_context.functionVec.push_back(funName);
+    mark();
+    startStats();
+    
+    // 1. Check if arguments match (a shared function gets them from its callers)
+    if (shared)
+        beginBlock(d_context.shared[funName].entry);
+    else if (args.size() != d_function.args.size())
         throw string("Argument mismatch.");
     
     // 2. Allocate and copy the arguments into the function-scope
@@ -28,12 +36,16 @@ Parser::Parser(Preprocessor::Parser const &preprocessor, string const &funName,
 
 Parser::~Parser()
 {
+    forgetAll();
+    
     // Free all variables with this function-prefix
-    for (size_t idx = 0; idx != s_memory.size(); ++idx)
-        if (s_memory[idx].find(d_function.name) != string::npos)
+    string prefix = variable("");
+    for (size_t idx = 0; idx != d_context.memory.size(); ++idx)
+        if (d_context.memory[idx].compare(0, prefix.length(), prefix) == 0)
             clear(idx);
     
-    s_functionVec.pop_back();
+    endStats();
+    d_context.functionVec.pop_back();
     delete d_streamPtr;
     d_out << flush;
 }
@@ -45,7 +57,7 @@ int Parser::getReturnValue()
     if (d_function.ret != "__void__")
     {
         returnAddress = allocate(d_function.ret);
-        s_memory[returnAddress] = s_tmpId;
+        d_context.memory[returnAddress] = s_tmpId;
     }
     
     return returnAddress;
@@ -53,11 +65,13 @@ int Parser::getReturnValue()
 
 int Parser::assign(int idx1, int idx2)
 {
+    Trace trace(*this, "assign");
     if (isPointer(idx2))
         return assignFromPointer(idx1, idx2);
     
     // not a pointer -> make sure idx1 is not listed as a pointer anymore
-    s_pointers.erase(idx1);
+    d_context.pointers.erase(idx1);
+    invalidate(idx1);
     
     // Assign!
     int tmp = getTemp();
@@ -87,46 +101,64 @@ int Parser::assign(int idx1, int idx2)
 
 int Parser::assign(int value)                   // assign an rvalue (e.g. 4) to a temporary memory location
 {
+    Trace trace(*this, "assign");
     int idx = getTemp();
     movePtr(idx);
     setValue(value);
+    d_context.constants[idx] = value;
     
     return idx;    
 }
 
 int Parser::assignFromPointer(int idx1, int idx2)
 {
+    Trace trace(*this, "assignFromPointer");
+    invalidate(idx1);
+    
     // Check if idx2 is a temporary pointer. If so, its content can be MOVED
-    if (s_memory[idx2] == s_tmpId)
+    if (d_context.memory[idx2] == s_tmpId)
     {
-        s_pointers[idx1] = s_pointers[idx2];    // the pointer at idx1 now points to whatever idx2 was pointing to
-        s_pointers.erase(idx2);                 // the temporary pointer idx2 no longer points to anything
+        d_context.pointers[idx1] = d_context.pointers[idx2];    // the pointer at idx1 now points to whatever idx2 was pointing to
+        d_context.pointers.erase(idx2);                 // the temporary pointer idx2 no longer points to anything
         return idx1;
     }
     
     // idx2 is not a temporary -> idx1 must point to a COPY of what idx2 is pointing to
-    int pos = s_pointers[idx2].first;
-    int len = s_pointers[idx2].second;
+    int pos = d_context.pointers[idx2].first;
+    int len = d_context.pointers[idx2].second;
     
     int cpy = findFreeMemory(len);      // find a free memory-block of the same size
+    if (cpy == -1)
+        throw string("Out of memory!");
     for (int el = 0; el != len; ++el)   // copy each element to the new block
     {
-        s_memory[cpy + el] = s_memory[pos + el];    // same identifier (e.g. __str__)
+        d_context.memory[cpy + el] = d_context.memory[pos + el];    // same identifier (e.g. __str__)
         assign(cpy + el, pos + el);                 // generate brainfuck code to copy the data
     }
     
-    s_pointers[idx1] = pair<int, int>(cpy, len);    // mark this index as a pointer
-    s_pointed[cpy] = len;
+    d_context.pointers[idx1] = pair<int, int>(cpy, len);    // mark this index as a pointer
+    d_context.pointed[cpy] = len;
     
     return idx1;
 }
 
 int Parser::assignToElement(int var, int offset, int val)
 {
+    Trace trace(*this, "assignToElement");
     if (!isPointer(var))
         throw string("Error: indexed variable is not an array or string.");   
         
-    int arr = s_pointers[var].first;
+    int arr = d_context.pointers[var].first;
+    forget(var);                        // elements read before are outdated
+    
+    // A constant offset within the array can be addressed directly
+    int cst;
+    if (isConstant(offset, cst) && cst < d_context.pointers[var].second)
+    {
+        assign(arr + cst, val);
+        return val;
+    }
+    
     int buf = getTemp(MAX_ARRAY_SIZE + 2);  // may need 2 extra cells if size == MAX_ARRAY_SIZE
     assign(buf, offset);
     assign(buf + 1, buf);
@@ -136,7 +168,7 @@ int Parser::assignToElement(int var, int offset, int val)
     string arr2buf(ABS(dist), (dist > 0 ? '>' : '<'));
     string buf2arr(ABS(dist), (dist > 0 ? '<' : '>'));
     
-    movePtr(buf);                                               // Pointer is now at buf (s_idx == buf)
+    movePtr(buf);                                               // Pointer is now at buf (d_context.idx == buf)
     d_out << "[>>[->+<]<[->+<]<[->+<]>-]";                      // move the right (unknown) amount to the right in the buffer
     d_out << buf2arr << "[-]" << arr2buf;                       // set the value in the array to 0
     d_out << ">>[-<<" << buf2arr << "+" << arr2buf << ">>]<";   // move the value into the buffer
@@ -150,6 +182,7 @@ int Parser::assignToElement(int var, int offset, int val)
 
 int Parser::addToElement(int var, int offset, int val)
 {
+    Trace trace(*this, "addToElement");
     if (!isPointer(var))
         throw string("Error: indexed variable is not an array or string.");   
         
@@ -162,6 +195,7 @@ int Parser::addToElement(int var, int offset, int val)
 
 int Parser::subtractFromElement(int var, int offset, int val)
 {
+    Trace trace(*this, "subtractFromElement");
     if (!isPointer(var))
         throw string("Error: indexed variable is not an array or string.");   
         
@@ -175,6 +209,7 @@ int Parser::subtractFromElement(int var, int offset, int val)
 
 int Parser::multiplyElement(int var, int offset, int val)
 {
+    Trace trace(*this, "multiplyElement");
     if (!isPointer(var))
         throw string("Error: indexed variable is not an array or string.");   
         
@@ -187,6 +222,7 @@ int Parser::multiplyElement(int var, int offset, int val)
 
 int Parser::divideElement(int var, int offset, int val)
 {
+    Trace trace(*this, "divideElement");
     if (!isPointer(var))
         throw string("Error: indexed variable is not an array or string.");   
         
@@ -199,6 +235,7 @@ int Parser::divideElement(int var, int offset, int val)
 
 int Parser::moduloElement(int var, int offset, int val)
 {
+    Trace trace(*this, "moduloElement");
     if (!isPointer(var))
         throw string("Error: indexed variable is not an array or string.");   
         
@@ -211,6 +248,7 @@ int Parser::moduloElement(int var, int offset, int val)
 
 int Parser::add(int idx1, int idx2)
 {
+    Trace trace(*this, "add");
     int tmp = getTemp();
     assign(tmp, idx1);
     addTo(tmp, idx2);
@@ -219,6 +257,7 @@ int Parser::add(int idx1, int idx2)
 
 int Parser::subtract(int idx1, int idx2) 
 {
+    Trace trace(*this, "subtract");
     int tmp = getTemp();
     assign(tmp, idx1);
     subtractFrom(tmp, idx2);
@@ -227,6 +266,7 @@ int Parser::subtract(int idx1, int idx2)
 
 int Parser::multiply(int idx1, int idx2)
 {
+    Trace trace(*this, "multiply");
     int tmp = getTemp();
     assign(tmp, idx1);
     multiplyBy(tmp, idx2);
@@ -235,6 +275,7 @@ int Parser::multiply(int idx1, int idx2)
 
 int Parser::divide(int idx1, int idx2)
 {
+    Trace trace(*this, "divide");
     int tmp = getTemp();
     assign(tmp, idx1);
     divideBy(tmp, idx2);
@@ -243,6 +284,7 @@ int Parser::divide(int idx1, int idx2)
 
 int Parser::modulo(int idx1, int idx2)
 {
+    Trace trace(*this, "modulo");
     int tmp = getTemp();
     assign(tmp, idx1);
     moduloBy(tmp, idx2);
@@ -251,6 +293,8 @@ int Parser::modulo(int idx1, int idx2)
 
 int Parser::addTo(int idx1, int idx2)
 {
+    Trace trace(*this, "addTo");
+    invalidate(idx1);
     int tmp = getTemp();
     assign(tmp, idx2);
     
@@ -266,6 +310,8 @@ int Parser::addTo(int idx1, int idx2)
 
 int Parser::subtractFrom(int idx1, int idx2)
 {
+    Trace trace(*this, "subtractFrom");
+    invalidate(idx1);
     int tmp = getTemp();
     assign(tmp, idx2);
     
@@ -281,6 +327,8 @@ int Parser::subtractFrom(int idx1, int idx2)
 
 int Parser::multiplyBy(int idx1, int idx2)
 {
+    Trace trace(*this, "multiplyBy");
+    invalidate(idx1);
     int tmp1 = getTemp();
     int tmp2 = getTemp();
     assign(tmp1, idx1);
@@ -299,6 +347,45 @@ int Parser::multiplyBy(int idx1, int idx2)
 
 int Parser::divideBy(int idx1, int idx2)
 {
+    Trace trace(*this, "divideBy");
+    if (d_context.target.wrap)          // subtracting too much would wrap around
+    {
+        // Count the dividend and the divisor down together. Whenever the
+        // divisor runs out, it's restored from rem, which counted along,
+        // and the quotient goes up: each step of the dividend is done once
+        int cnt = getTemp();
+        int quo = getTemp();
+        int rem = getTemp();
+        int div = getTemp(3);       // followed by the cells startIfZero() needs
+        assign(cnt, idx1);
+        assign(div, idx2);
+        movePtr(div + 1);
+        setValue(1);
+
+        movePtr(cnt);
+        d_out << "[-";
+        movePtr(div);
+        d_out << "-";
+        movePtr(rem);
+        d_out << "+";
+        startIfZero(div);
+        movePtr(rem);
+        d_out << "[-";
+        movePtr(div);
+        d_out << "+";
+        movePtr(rem);
+        d_out << "]";
+        movePtr(quo);
+        d_out << "+";
+        stopIfZero(div);
+        movePtr(cnt);
+        d_out << "]";
+
+        movePtr(div + 1);
+        setValue(0);
+        return assign(idx1, quo);
+    }
+    
     int cpy = getTemp();
     int div = getTemp();
     
@@ -334,6 +421,7 @@ int Parser::divideBy(int idx1, int idx2)
 
 int Parser::moduloBy(int idx1, int idx2)
 {
+    Trace trace(*this, "moduloBy");
     int tmp = getTemp();
     assign(tmp, idx1);
     divideBy(tmp, idx2);
@@ -344,6 +432,11 @@ int Parser::moduloBy(int idx1, int idx2)
 
 int Parser::lt(int idx1, int idx2)
 {
+    Trace trace(*this, "lt");
+    if (d_context.target.wrap)
+        return wrappingLt(idx1, idx2);
+    
+    // Counting idx2 down idx1 times leaves something only if it's larger
     int tmp1 = getTemp();
     int tmp2 = getTemp();
     int ret = getTemp();
@@ -368,8 +461,50 @@ int Parser::lt(int idx1, int idx2)
     return ret;
 }
 
+int Parser::wrappingLt(int idx1, int idx2)
+{
+    // Count both down until either runs out, never going below 0
+    int ret = getTemp();
+    int cnt = getTemp();
+    int rem = getTemp(3);       // followed by the cells startIfZero() needs
+    assign(cnt, idx1);
+    assign(rem, idx2);
+    movePtr(ret);
+    setValue(1);
+    movePtr(rem + 1);
+    setValue(1);
+    
+    startIfZero(rem);           // nothing is less than 0
+    movePtr(ret);
+    setValue(0);
+    movePtr(cnt);
+    setValue(0);
+    stopIfZero(rem);
+    
+    movePtr(cnt);
+    d_out << "[";
+    movePtr(rem);
+    d_out << "-";
+    startIfZero(rem);           // idx2 ran out first (or at the same time)
+    movePtr(ret);
+    setValue(0);
+    movePtr(cnt);
+    setValue(1);
+    stopIfZero(rem);
+    movePtr(cnt);
+    d_out << "-]";
+    
+    movePtr(rem + 1);
+    setValue(0);
+    return ret;
+}
+
 int Parser::gt(int idx1, int idx2)
 {
+    Trace trace(*this, "gt");
+    if (d_context.target.wrap)
+        return wrappingLt(idx2, idx1);
+    
     int tmp1 = getTemp();
     int tmp2 = getTemp();
     int ret = getTemp();
@@ -396,6 +531,10 @@ int Parser::gt(int idx1, int idx2)
 
 int Parser::eq(int idx1, int idx2)
 {
+    Trace trace(*this, "eq");
+    if (d_context.target.wrap)          // the difference is only 0 if they're equal
+        return logicNot(subtract(idx1, idx2));
+    
     int less = lt(idx1, idx2);
     int more = gt(idx1, idx2);
     int flag = getTemp();
@@ -424,6 +563,10 @@ int Parser::eq(int idx1, int idx2)
 
 int Parser::ne(int idx1, int idx2)
 {
+    Trace trace(*this, "ne");
+    if (d_context.target.wrap)
+        return logicNot(logicNot(subtract(idx1, idx2)));
+    
     int less = lt(idx1, idx2);
     int more = gt(idx1, idx2);
     int ret = getTemp();
@@ -447,176 +590,266 @@ int Parser::ne(int idx1, int idx2)
 
 int Parser::le(int idx1, int idx2)
 {
-    int less = lt(idx1, idx2);
-    int same = eq(idx1, idx2);
+    Trace trace(*this, "le");
+    return logicNot(gt(idx1, idx2));
+}
+
+int Parser::ge(int idx1, int idx2)
+{
+    Trace trace(*this, "ge");
+    return logicNot(lt(idx1, idx2));
+}
+
+int Parser::logicAnd(int idx1, int idx2)
+{
+    Trace trace(*this, "logicAnd");
+    // The second operand is only tested if the first one is true
     int ret = getTemp();
-    
-    movePtr(less);
+    int flg1 = condition(idx1);
+    movePtr(flg1);
+    d_out << "[[-]";        // set to 0 to make sure the body is executed only once
+    int flg2 = condition(idx2);
+    movePtr(flg2);
     d_out << "[[-]";
     movePtr(ret);
-    setValue(1);
-    movePtr(less);
+    d_out << "+";
+    movePtr(flg2);
     d_out << "]";
-    
-    movePtr(same);
-    d_out << "[[-]";
-    movePtr(ret);
-    setValue(1);
-    movePtr(same);
+    movePtr(flg1);
     d_out << "]";
     
+    if (flg2 == idx2)       // not tested when the first operand was false
+    {
+        movePtr(flg2);
+        d_out << "[-]";
+    }
+    
+    clear(flg1);            // both are 0 now and can be reused right away
+    clear(flg2);
     return ret;
 }
 
-int Parser::ge(int idx1, int idx2)
+int Parser::logicOr(int idx1, int idx2)
 {
-    int more = gt(idx1, idx2);
-    int same = eq(idx1, idx2);
+    Trace trace(*this, "logicOr");
+    // The second operand is only tested if the first one is false
     int ret = getTemp();
+    int els = getTemp();
+    movePtr(els);
+    d_out << "+";
     
-    movePtr(more);
+    int flg1 = condition(idx1);
+    movePtr(flg1);
     d_out << "[[-]";
     movePtr(ret);
-    setValue(1);
-    movePtr(more);
+    d_out << "+";
+    movePtr(els);
+    d_out << "-";
+    movePtr(flg1);
     d_out << "]";
     
-    movePtr(same);
+    movePtr(els);
+    d_out << "[-";
+    int flg2 = condition(idx2);
+    movePtr(flg2);
     d_out << "[[-]";
     movePtr(ret);
-    setValue(1);
-    movePtr(same);
+    d_out << "+";
+    movePtr(flg2);
     d_out << "]";
-    
-    return ret;
-}
-
-int Parser::logicAnd(int idx1, int idx2)
-{
-    int tmp1 = getTemp();
-    int tmp2 = getTemp();
-    int cpy1 = getTemp();
-    int cpy2 = getTemp();
-    assign(cpy1, idx1);
-    assign(cpy2, idx2);
-    
-    movePtr(cpy1);
-    d_out << "[[-]";        // set to 0 to make sure the body is executed only once
-    movePtr(tmp1);
-    setValue(1);
-    movePtr(cpy1);
+    movePtr(els);
     d_out << "]";
     
-    movePtr(cpy2);
-    d_out << "[[-]";
-    movePtr(tmp2);
-    setValue(1);
-    movePtr(cpy2);
-    d_out << "]";
+    if (flg2 == idx2)       // not tested when the first operand was true
+    {
+        movePtr(flg2);
+        d_out << "[-]";
+    }
     
-    multiplyBy(tmp1, tmp2);
-    return tmp1;
+    clear(els);
+    clear(flg1);
+    clear(flg2);
+    return ret;
 }
 
-int Parser::logicOr(int idx1, int idx2)
+int Parser::common(string const &op, int idx1, int idx2)
 {
-    int tmp1 = getTemp();
-    int tmp2 = getTemp();
-    int tmp3 = getTemp();
-    int cpy1 = getTemp();
-    int cpy2 = getTemp();
-    assign(cpy1, idx1);
-    assign(cpy2, idx2);
-    
-    movePtr(cpy1);
-    d_out << "[[-]";        // set to 0 to make sure the body is executed only once
-    movePtr(tmp1);
-    setValue(1);
-    movePtr(cpy1);
-    d_out << "]";
+    // Reuse the result of the same operation on unchanged operands
+    int lhs = operand(idx1);
+    int rhs = idx2 == -1 ? -1 : operand(idx2);
+    if ((op == "+" || op == "*" || op == "==" || op == "!=" || op == "&&" || op == "||") && rhs < lhs)
+        swap(lhs, rhs);
     
-    movePtr(cpy2);
-    d_out << "[[-]";
-    movePtr(tmp2);
-    setValue(1);
-    movePtr(cpy2);
-    d_out << "]";
+    for (size_t idx = 0; idx != d_context.common.size(); ++idx)
+    {
+        Common const &entry = d_context.common[idx];
+        if (entry.op == op && entry.lhs == lhs && entry.rhs == rhs)
+            return entry.result;
+    }
     
-    addTo(tmp1, tmp2);
-    movePtr(tmp1);
-    d_out << "[[-]";
-    movePtr(tmp3);
-    setValue(1);
-    movePtr(tmp1);
-    d_out << "]";
+    int ret;
+    if (op == "+")
+        ret = add(idx1, idx2);
+    else if (op == "-")
+        ret = subtract(idx1, idx2);
+    else if (op == "*")
+        ret = multiply(idx1, idx2);
+    else if (op == "/")
+        ret = divide(idx1, idx2);
+    else if (op == "%")
+        ret = modulo(idx1, idx2);
+    else if (op == "<")
+        ret = lt(idx1, idx2);
+    else if (op == ">")
+        ret = gt(idx1, idx2);
+    else if (op == "<=")
+        ret = le(idx1, idx2);
+    else if (op == ">=")
+        ret = ge(idx1, idx2);
+    else if (op == "==")
+        ret = eq(idx1, idx2);
+    else if (op == "!=")
+        ret = ne(idx1, idx2);
+    else if (op == "&&")
+        ret = logicAnd(idx1, idx2);
+    else if (op == "||")
+        ret = logicOr(idx1, idx2);
+    else if (op == "!")
+        ret = logicNot(idx1);
+    else
+        ret = arrayValue(idx1, idx2);
+    
+    // Keep the result beyond this statement (all of the above return a
+    // fresh temporary), but not in too many cells
+    if (d_context.common.size() == MAX_COMMON)
+    {
+        d_context.memory[d_context.common.front().result] = s_oldId;
+        d_context.common.erase(d_context.common.begin());
+    }
     
-    return tmp3;
+    d_context.memory[ret] = s_cseId;
+    d_context.common.push_back(Common{op, lhs, rhs, ret, d_context.serials++});
+    return ret;
 }
 
 int Parser::logicNot(int idx)
 {
-    int tmp = getTemp();
-    int flg = getTemp();
+    Trace trace(*this, "logicNot");
     int ret = getTemp();
+    movePtr(ret);
+    d_out << "+";
     
-    assign(tmp, idx);
-    movePtr(tmp);
+    int flg = condition(idx);
+    movePtr(flg);
     d_out << "[[-]";
+    movePtr(ret);
+    d_out << "-";
     movePtr(flg);
-    setValue(1);
-    movePtr(tmp);
     d_out << "]";
     
-    movePtr(ret);
-    setValue(1);
-    subtractFrom(ret, flg);
+    clear(flg);
     return ret;
 }
 
 void Parser::startIf(int idx)
 {
-    // First set two flags, indicating whether it should enter the if or else (if available)
-    int ifFlag = getFlag();
-    int elFlag = getFlag();
-    int tmp    = getTemp();
-    
-    d_stack.push({ifFlag, elFlag});     // push the flag adresses on the stack
+    Trace trace(*this, "startIf");
+    d_dominators.push(d_context.common);
+    size_t control = d_control;         // see nextBlockMode()
+    if (nextBlockMode())
+    {
+        int ifBlock = reserve();
+        int elBlock = reserve();
+        int nextBlock = reserve();
+        
+        d_stack.push({});
+        d_blocks.push({ifBlock, elBlock, nextBlock});
+        branch(idx, ifBlock, elBlock);
+        beginBlock(ifBlock);
+        return;
+    }
+    d_blocks.push({});
     
-    movePtr(elFlag);                    // ifFlag is already 0
-    setValue(1);                        // set elseFlag to 1
+    // The (copy of the) condition itself is the if-flag. It has to survive
+    // the statements of the body, so it is tagged as a flag.
+    int ifFlag = condition(idx);
+    d_context.memory[ifFlag] = s_stcId;
     
-    assign(tmp, idx);
-    movePtr(tmp);
-    d_out << "[[-]";                    // if the conditional is nonzero
-    movePtr(ifFlag);                    // the if-flag will become 1
-    setValue(1);
-    movePtr(elFlag);                    // and the else-flag will become 0
-    setValue(0);
-    movePtr(tmp);
-    d_out << "]";
+    if (control < d_elses.size() && !d_elses[control])
+        d_stack.push({ifFlag});
+    else
+    {
+        int elFlag = getFlag();         // cleared by the if-part, if executed
+        movePtr(elFlag);
+        setValue(1);
+        d_stack.push({ifFlag, elFlag});
+    }
     
     movePtr(ifFlag);
-    d_out << "[-";    // all statements hereafter will be executed only of the ifFlag was nonzero (1)
+    d_out << "[";     // all statements hereafter will be executed only if the ifFlag is nonzero
 }
 
 void Parser::stopIf()
 {
-    int ifFlag = d_stack.top()[0];
-    movePtr(ifFlag);
-    d_out << "]";
+    Trace trace(*this, "stopIf");
+    forgetBranch();
+    d_dominators.pop();
+    if (!d_blocks.top().empty())   // no else: its block just continues after the if
+    {
+        endBlock(d_blocks.top()[2]);
+        beginBlock(d_blocks.top()[1]);
+        endBlock(d_blocks.top()[2]);
+        beginBlock(d_blocks.top()[2]);
+        return;
+    }
+    
+    // The if-flag may hold any nonzero value
+    vector<int> const &flags = d_stack.top();
+    movePtr(flags[0]);
+    d_out << "[-]]";
+    
+    if (flags.size() == 2)          // an else-flag that turned out not to be needed
+    {
+        movePtr(flags[1]);
+        setValue(0);
+    }
 }
 
 void Parser::startElse()
 {
-    stopIf();
+    Trace trace(*this, "startElse");
+    forgetBranch();
+    if (!d_blocks.top().empty())
+    {
+        endBlock(d_blocks.top()[2]);
+        beginBlock(d_blocks.top()[1]);
+        return;
+    }
+    
+    int ifFlag = d_stack.top()[0];
     int elFlag = d_stack.top()[1];
     
+    movePtr(elFlag);                    // end of the if-part
+    d_out << "-";
+    movePtr(ifFlag);
+    d_out << "[-]]";
+    
     movePtr(elFlag);
     d_out << "[-";
 }
 
 void Parser::stopIfElse()
 {
+    Trace trace(*this, "stopIfElse");
+    forgetBranch();
+    d_dominators.pop();
+    if (!d_blocks.top().empty())
+    {
+        endBlock(d_blocks.top()[2]);
+        beginBlock(d_blocks.top()[2]);
+        return;
+    }
+    
     int elFlag = d_stack.top()[1];
     movePtr(elFlag);
     d_out << "]";
@@ -624,6 +857,8 @@ void Parser::stopIfElse()
 
 void Parser::startFor(int var, int start, int step_, int stop_)
 {
+    Trace trace(*this, "startFor");
+    forgetAll();
     int step = getFlag();
     int stop = getFlag();
     int flag = getFlag();
@@ -641,6 +876,21 @@ void Parser::startFor(int var, int start, int step_, int stop_)
     d_stack.push({var, step, stop, flag});
     
     assign(var, start);
+    if (nextBlockMode())
+    {
+        int testBlock = reserve();
+        int bodyBlock = reserve();
+        int nextBlock = reserve();
+        
+        d_blocks.push({testBlock, bodyBlock, nextBlock});
+        endBlock(testBlock);
+        beginBlock(testBlock);
+        branch(le(var, stop), bodyBlock, nextBlock);
+        beginBlock(bodyBlock);
+        return;
+    }
+    d_blocks.push({});
+    
     assign(flag, le(var, stop));
     movePtr(flag);
     d_out << "[";
@@ -648,12 +898,21 @@ void Parser::startFor(int var, int start, int step_, int stop_)
 
 void Parser::stopFor()
 {
+    Trace trace(*this, "stopFor");
+    forgetAll();
     int var = d_stack.top()[0];
     int step = d_stack.top()[1];
     int stop = d_stack.top()[2];
     int flag = d_stack.top()[3];
     
     addTo(var, step);
+    if (!d_blocks.top().empty())
+    {
+        endBlock(d_blocks.top()[0]);
+        beginBlock(d_blocks.top()[2]);
+        return;
+    }
+    
     assign(flag, le(var, stop));
     movePtr(flag);
     d_out << "]";
@@ -661,8 +920,10 @@ void Parser::stopFor()
 
 void Parser::popStack()
 {
+    Trace trace(*this, "popStack");
     vector<int> vars = d_stack.top();
     d_stack.pop();
+    d_blocks.pop();
 
     for (size_t idx = 0; idx != vars.size(); ++idx)
         clear(vars[idx]);
@@ -670,27 +931,37 @@ void Parser::popStack()
 
 void Parser::clear(int idx)
 {
-    s_memory[idx] = string();
+    d_context.memory[idx] = string();
+    d_context.constants.erase(idx);
+    d_context.literals.erase(idx);
+    forget(idx);
 }
 
 void Parser::collectGarbage()
 {
+    Trace trace(*this, "collectGarbage");
+    ++d_context.stats.functions[d_function.name].collections;
+    // Free the variables that are not used anymore after this statement
+    vector<string> const &dead = d_liveness.dead(++d_statement);
+    for (size_t idx = 0; idx != dead.size(); ++idx)
+        freeVariable(dead[idx]);
+
     // Clear all temporaries from the memory
-    for (size_t idx = 0; idx != s_memory.size(); ++idx)
+    for (size_t idx = 0; idx != d_context.memory.size(); ++idx)
     {
-        if (s_memory[idx] == s_tmpId)
+        if (d_context.memory[idx] == s_tmpId || d_context.memory[idx] == s_oldId)
         {
             clear(idx);
-            s_pointers.erase(idx);    // in case it was a temporary pointer, erase it
+            d_context.pointers.erase(idx);    // in case it was a temporary pointer, erase it
         }
     }
         
     // Now, delete the memory that is NOT being referenced anymore
-    for (auto it1 = s_pointed.begin(); it1 != s_pointed.end(); ++it1)
+    for (auto it1 = d_context.pointed.begin(); it1 != d_context.pointed.end(); )
     {
         int idx = it1->first;        // index that should be pointed to by one of the pointers
         bool referenced = false;
-        for (auto it2 = s_pointers.begin(); it2 != s_pointers.end(); ++it2)
+        for (auto it2 = d_context.pointers.begin(); it2 != d_context.pointers.end(); ++it2)
         {
             if (it2->second.first == idx)
             {
@@ -705,19 +976,38 @@ void Parser::collectGarbage()
             for (size_t i = 0; i != len; ++i)
                 clear(idx + i);
             
-            s_pointed.erase(idx);          // not pointed to this index!
+            it1 = d_context.pointed.erase(it1);    // not pointed to this index!
         }
+        else
+            ++it1;
     }
             
 }
 
+void Parser::freeVariable(std::string const &ident)
+{
+    if (ident == d_function.ret)    // still needed by getReturnValue()
+        return;
+    
+    string varName = variable(ident);
+    for (size_t idx = 0; idx != d_context.memory.size(); ++idx)
+    {
+        if (d_context.memory[idx] == varName)
+        {
+            clear(idx);
+            d_context.pointers.erase(idx);  // whatever it pointed to can be collected now
+            return;
+        }
+    }
+}
+
 int Parser::allocate(std::string const &ident)
 {
     string varName = variable(ident);
     
     // 1. Check of identifier already exists
-    for (size_t idx = 0; idx != s_memory.size(); ++idx)
-        if (s_memory[idx] == varName)
+    for (size_t idx = 0; idx != d_context.memory.size(); ++idx)
+        if (d_context.memory[idx] == varName)
             return idx;
         
     // 2. Does not exist yet -> find empty location in memory and create the variable
@@ -725,39 +1015,42 @@ int Parser::allocate(std::string const &ident)
     if (idx == -1)
         throw string("Out of memory!");
         
-    s_memory[idx] = varName;
+    d_context.memory[idx] = varName;
     return idx;    
 }
 
 int Parser::allocString(std::string const &str)
 {
-    int len = str.length();
+    Trace trace(*this, "allocString");
+    // Only stored in memory when used as a pointer (see isPointer()),
+    // prints can do without
     int ptr = getTemp();                // will point to the string
-    int idx = getTemp(len + 1);         // also allocate \0
+    d_context.literals[ptr] = str;
+    return ptr;
+}
+
+void Parser::storeString(int ptr, std::string const &str)
+{
+    int len = str.length();
+    int idx = getTemp(len + 1);         // also allocate \0, which is already set
     
     // Build the string in memory
+    vector<int> values;
     for (int jdx = 0; jdx != len; ++jdx)
-    {
-        movePtr(idx + jdx);
-        setValue(str[jdx]);
-        s_memory[idx + jdx] = s_refId;
-    }
+        values.push_back(static_cast<unsigned char>(str[jdx]));
+    setValues(idx, values);
     
-    // Set terminating \0 char
-    movePtr(idx + len);
-    setValue(0);
-    s_memory[idx + len] = s_refId;
+    for (int jdx = 0; jdx != len + 1; ++jdx)
+        d_context.memory[idx + jdx] = s_refId;
 
     // Set the pointer variables
-    s_pointers[ptr] = pair<int, int>(idx, len + 1);
-    s_pointed[idx] = len + 1;
-    
-    // Return the pointer
-    return ptr;
+    d_context.pointers[ptr] = pair<int, int>(idx, len + 1);
+    d_context.pointed[idx] = len + 1;
 }
 
 int Parser::allocArray(vector<int> const &list)
 {
+    Trace trace(*this, "allocArray");
     size_t numel = list.size();
     if (numel > MAX_ARRAY_SIZE)
     {
@@ -772,18 +1065,26 @@ int Parser::allocArray(vector<int> const &list)
     
     for (size_t idx = 0; idx != numel; ++idx)
     {
-        assign(arr + idx, list[idx]);
-        s_memory[arr + idx] = s_refId;
+        int cst;
+        if (isConstant(list[idx], cst))     // no need to copy it
+        {
+            movePtr(arr + idx);
+            setValue(cst);
+        }
+        else
+            assign(arr + idx, list[idx]);
+        d_context.memory[arr + idx] = s_refId;
     }
     
-    s_pointers[ptr] = pair<int, int>(arr, numel);
-    s_pointed[arr] = numel;
+    d_context.pointers[ptr] = pair<int, int>(arr, numel);
+    d_context.pointed[arr] = numel;
     
     return ptr;
 }
 
 int Parser::allocArray(int numel, int val_)
 {
+    Trace trace(*this, "allocArray");
     if (numel > (int)MAX_ARRAY_SIZE)
     {
         cout << "Warning: array is bigger than the maximum size of " << MAX_ARRAY_SIZE << " elements: extra elements are ignored.";
@@ -797,20 +1098,31 @@ int Parser::allocArray(int numel, int val_)
     for (int idx = 0; idx != numel; ++idx)
     {
         assign(arr + idx, val);
-        s_memory[arr + idx] = s_refId;
+        d_context.memory[arr + idx] = s_refId;
     }
     
-    s_pointers[ptr] = pair<int, int>(arr, numel);
-    s_pointed[arr] = numel;
+    d_context.pointers[ptr] = pair<int, int>(arr, numel);
+    d_context.pointed[arr] = numel;
     return ptr;
 }
 
 int Parser::arrayValue(int idx1, int idx2)
 {
+    Trace trace(*this, "arrayValue");
     if (!isPointer(idx1))
         throw string("Error: indexed variable is not an array or string.");
 
-    int arr = s_pointers[idx1].first;
+    int arr = d_context.pointers[idx1].first;
+    
+    // A constant index within the array can be copied directly
+    int cst;
+    if (isConstant(idx2, cst) && cst < d_context.pointers[idx1].second)
+    {
+        int ret = getTemp();
+        assign(ret, arr + cst);
+        return ret;
+    }
+    
     int buf = getTemp(MAX_ARRAY_SIZE + 2);  // may need 2 extra cells if size == MAX_ARRAY_SIZE
     assign(buf, idx2);
     assign(buf + 1, buf);
@@ -835,20 +1147,29 @@ int Parser::arrayValue(int idx1, int idx2)
 
 int Parser::findFreeMemory(int size)
 {
-    for (size_t idx = 0; idx != s_memory.size(); ++idx)
+    for (size_t idx = 0; idx + size <= d_context.memory.size(); ++idx)
     {
-        if (s_memory[idx].empty())
+        if (d_context.memory[idx].empty())
         {
             int succes = true;
             for (int jdx = 1; jdx != size; ++jdx)
-                if (!s_memory[idx + jdx].empty())
+                if (!d_context.memory[idx + jdx].empty())
                 {
                     succes = false;
                     break;
                 }
                 
             if (succes)
+            {
+                d_context.maxIdx = max(d_context.maxIdx, (int)idx + size - 1);
+                FunctionStats &stats = d_context.stats.functions[d_context.functionVec.back()];
+                stats.cells += size;
+                stats.peak = max(stats.peak, idx + size);
+                if (!d_context.sharing.empty())
+                    for (int jdx = 0; jdx != size; ++jdx)
+                        d_context.touched.insert(idx + jdx);
                 return idx;
+            }
         }
     }
             
@@ -863,7 +1184,7 @@ int Parser::getTemp(int size)
     
     for (int jdx = 0; jdx != size; ++jdx)
     {
-        s_memory[idx + jdx] = s_tmpId;
+        d_context.memory[idx + jdx] = s_tmpId;
         movePtr(idx + jdx);
         setValue(0);
     }
@@ -871,13 +1192,29 @@ int Parser::getTemp(int size)
     return idx;
 }
 
+void Parser::startIfZero(int idx)
+{
+    // Tests idx without changing it. idx + 1 has to be 1 and idx + 2 has to
+    // be 0: the pointer ends up at idx + 1 if idx is 0 and at idx + 2 if not,
+    // so the code between here and stopIfZero() is only run in the first case.
+    movePtr(idx);
+    d_out << "[>-]>[<";
+}
+
+void Parser::stopIfZero(int idx)
+{
+    // Either way, the pointer ends up at idx + 2, and idx + 1 is restored
+    movePtr(idx);
+    d_out << ">->]<+<";
+}
+
 int Parser::getFlag()
 {
     int idx = findFreeMemory();
     if (idx == -1)
         throw string("Out of memory!");
     
-    s_memory[idx] = s_stcId;
+    d_context.memory[idx] = s_stcId;
     movePtr(idx);
     setValue(0);
     return idx;
@@ -886,6 +1223,7 @@ int Parser::getFlag()
 
 int Parser::printc(int idx)
 {
+    Trace trace(*this, "printc");
     movePtr(idx);
     d_out << '.';
     return idx;
@@ -893,53 +1231,86 @@ int Parser::printc(int idx)
 
 int Parser::printd(int idx)
 {
-    int cpy = getTemp();
-    assign(cpy, idx);
+    Trace trace(*this, "printd");
+    // As many digits as the largest value of a cell has, including leading zeros
+    int digits = d_context.target.cellBits == 8 ? 3 : d_context.target.cellBits == 16 ? 5 : 10;
+    
+    int num = getTemp();
+    assign(num, idx);
     
-    int hun = getTemp();
     int ten = getTemp();
     int aaa = getTemp();
-    int c1 = getTemp();
-    int c2 = getTemp();
-    
-    movePtr(hun);
-    setValue(100);
     movePtr(ten);
     setValue(10);
     movePtr(aaa);
     setValue(48);
     
-    assign(c1, divide(cpy, hun));
-    moduloBy(cpy, hun);
-    assign(c2, divide(cpy, ten));
-    moduloBy(cpy, ten);
+    // Split off the last digit until only the first one is left
+    vector<int> chars(digits);
+    for (int jdx = digits - 1; jdx != 0; --jdx)
+    {
+        int quo = divide(num, ten);
+        subtractFrom(num, multiply(quo, ten));
+        chars[jdx] = num;
+        num = quo;
+    }
+    chars[0] = num;
+    
+    for (int jdx = 0; jdx != digits; ++jdx)
+    {
+        addTo(chars[jdx], aaa);
+        printc(chars[jdx]);
+    }
     
-    addTo(c1, aaa);
-    printc(c1);
-    addTo(c2, aaa);
-    printc(c2);
-    addTo(cpy, aaa);
-    printc(cpy);
-
     return idx;
 }
 
 int Parser::prints(int idx)
 {
+    Trace trace(*this, "prints");
+    // A literal is printed from a single cell, changed from one character
+    // to the next
+    auto lit = d_context.literals.find(idx);
+    if (lit != d_context.literals.end())
+    {
+        int chr = getTemp();
+        int cnt = getTemp();
+        int val = 0;
+        for (size_t jdx = 0; jdx != lit->second.length(); ++jdx)
+        {
+            int next = static_cast<unsigned char>(lit->second[jdx]);
+            if (next + 3 < abs(next - val))     // cheaper to start over
+            {
+                movePtr(chr);
+                d_out << "[-]";
+                val = 0;
+            }
+            
+            addValue(chr, cnt, next - val);
+            val = next;
+            movePtr(chr);
+            d_out << '.';
+        }
+        
+        return idx;
+    }
+    
     // idx is a pointer to a string -> get the actual index
-    int jdx = s_pointers[idx].first;
-    int len = s_pointers[idx].second;
+    int jdx = d_context.pointers[idx].first;
+    int len = d_context.pointers[idx].second;
     
     // jdx is now the actual index of the string
     movePtr(jdx);
     d_out << "[.>]";
-    s_idx += len - 1;      // pointer has moved over this distance
+    d_context.idx += len - 1;      // pointer has moved over this distance
     
     return idx;
 }
 
 int Parser::scan(int idx)
 {
+    Trace trace(*this, "scan");
+    invalidate(idx);
     movePtr(idx);
     d_out << ',';
     return idx;
@@ -947,59 +1318,269 @@ int Parser::scan(int idx)
 
 void Parser::movePtr(int idx)
 {
-    static char moveLeft = '<';
-    static char moveRight = '>';
+    static char const moveLeft = '<';
+    static char const moveRight = '>';
     
-    int diff = idx - s_idx;
+    int diff = idx - d_context.idx;
     char ch = diff < 0 ? moveLeft : moveRight;
-    s_idx = idx;
+    d_context.idx = idx;
+    d_context.maxIdx = max(d_context.maxIdx, idx);
 
     d_out << string(ABS(diff), ch);
 }
 
 void Parser::setValue(int val)
 {
+    Trace trace(*this, "setValue");
+    // Values in the upper half are reached sooner by counting down from 0
+    // on wrapping cells. Larger literals wrap around like the cells do.
+    char change = '+';
+    long long range = 1LL << d_context.target.cellBits;
+    if (d_context.target.wrap)
+        val %= range;
+    if (d_context.target.wrap && val > range / 2)
+    {
+        val = range - val;
+        change = '-';
+    }
+    
     if (val <= 10)
     {
-       d_out << "[-]" << string(val, '+');
+       d_out << "[-]" << string(val, change);
        return;
     }
     
     int tens = val / 10;
     int ones = val % 10;
-    int idx = s_idx;
+    int idx = d_context.idx;
     d_out << "[-]";
     
     int count = findFreeMemory();
-    s_memory[count] = s_tmpId;                           // can't use getTemp() here, it would call setValue -> infinite recursion
+    if (count == -1)
+        throw string("Out of memory!");
+    d_context.memory[count] = s_tmpId;                           // can't use getTemp() here, it would call setValue -> infinite recursion
     movePtr(count);
     d_out << "[-]" << string(tens, '+');
     
     d_out << "[-";      
     movePtr(idx);
-    d_out << string(10, '+');
+    d_out << string(10, change);
     movePtr(count);
     d_out << "]";
     
     if (ones)
     {
         movePtr(idx);
-        d_out << string(ones, '+');
+        d_out << string(ones, change);
     }
 }
 
+void Parser::setValues(int idx, vector<int> const &values)
+{
+    // The cells are 0. A single loop adds a multiple of the same step to
+    // each of them, after which they are adjusted one by one. Pick the
+    // step (1: no loop at all) that takes the fewest instructions.
+    int step = 1;
+    size_t best = 0;
+    for (size_t jdx = 0; jdx != values.size(); ++jdx)
+        best += values[jdx];
+    
+    vector<int> factors(values.size());
+    for (int k = 2; k <= 16; ++k)
+    {
+        size_t count = k + 4;           // setting the counter, "[-" and "]"
+        vector<int> current(values.size());
+        for (size_t jdx = 0; jdx != values.size(); ++jdx)
+        {
+            // Adding the factor in the loop costs an instruction as well
+            int lower = values[jdx] / k;
+            int upper = min(lower + 1, 255 / k);
+            int costLower = lower + values[jdx] - lower * k;
+            int costUpper = upper + abs(values[jdx] - upper * k);
+            current[jdx] = costUpper < costLower ? upper : lower;
+            count += min(costLower, costUpper);
+        }
+        
+        if (count < best)
+        {
+            best = count;
+            step = k;
+            factors.swap(current);
+        }
+    }
+    
+    if (step != 1)
+    {
+        int cnt = getTemp();
+        movePtr(cnt);
+        d_out << string(step, '+') << "[-";
+        for (size_t jdx = 0; jdx != values.size(); ++jdx)
+        {
+            if (factors[jdx] == 0)
+                continue;
+            movePtr(idx + jdx);
+            d_out << string(factors[jdx], '+');
+        }
+        movePtr(cnt);
+        d_out << "]";
+    }
+    
+    for (size_t jdx = 0; jdx != values.size(); ++jdx)
+    {
+        int diff = values[jdx] - factors[jdx] * step;
+        if (diff == 0)
+            continue;
+        movePtr(idx + jdx);
+        d_out << string(abs(diff), diff > 0 ? '+' : '-');
+    }
+}
+
+void Parser::addValue(int idx, int cnt, int diff)
+{
+    // Adds a multiple of a step in a loop on cnt (which is 0), if that's
+    // shorter. It never overshoots, as cells can't go below 0.
+    char change = diff > 0 ? '+' : '-';
+    int count = abs(diff);
+    int step = 1;
+    int best = count;
+    for (int k = 2; k <= 16; ++k)
+    {
+        int length = k + count / k + count % k + 8;     // including "[-" "]" and moves
+        if (length < best)
+        {
+            best = length;
+            step = k;
+        }
+    }
+    
+    if (step != 1)
+    {
+        movePtr(cnt);
+        d_out << string(step, '+') << "[-";
+        movePtr(idx);
+        d_out << string(count / step, change);
+        movePtr(cnt);
+        d_out << "]";
+        count %= step;
+    }
+    
+    movePtr(idx);
+    d_out << string(count, change);
+}
+
 bool Parser::isPointer(int idx)
 {
-    return s_pointers.find(idx) != s_pointers.end();
+    // A string literal is put into memory once it's used as a pointer
+    auto lit = d_context.literals.find(idx);
+    if (lit != d_context.literals.end())
+    {
+        string str = lit->second;
+        d_context.literals.erase(lit);
+        storeString(idx, str);
+    }
+    
+    return d_context.pointers.find(idx) != d_context.pointers.end();
+}
+
+bool Parser::isConstant(int idx, int &value)
+{
+    auto it = d_context.constants.find(idx);
+    if (it == d_context.constants.end())
+        return false;
+    
+    value = it->second;
+    return true;
+}
+
+void Parser::invalidate(int idx)
+{
+    d_context.constants.erase(idx);     // idx is about to be overwritten
+    forget(idx);
+}
+
+int Parser::condition(int idx)
+{
+    // A temporary is only used once, so it may be cleared by testing it.
+    // Anything else, common results included, is tested on a copy.
+    if (d_context.memory[idx] == s_tmpId && !isPointer(idx))
+    {
+        invalidate(idx);
+        return idx;
+    }
+    
+    int cpy = getTemp();
+    assign(cpy, idx);
+    return cpy;
+}
+
+int Parser::operand(int idx)
+{
+    int value;
+    if (isConstant(idx, value))     // equal constants are interchangeable
+        return -2 - value;
+    
+    return idx;
+}
+
+void Parser::forget(int idx)
+{
+    // Results computed from idx are outdated. They may still be used in the
+    // current statement, so they're freed at its end.
+    for (size_t jdx = d_context.common.size(); jdx--; )
+    {
+        Common const &entry = d_context.common[jdx];
+        if (entry.lhs != idx && entry.rhs != idx && entry.result != idx)
+            continue;
+        
+        if (entry.result != idx)
+            d_context.memory[entry.result] = s_oldId;
+        d_context.common.erase(d_context.common.begin() + jdx);
+    }
+}
+
+void Parser::forgetBranch()
+{
+    // Only results computed before the if are available after a branch,
+    // provided nothing in the branch changed their operands. An entry that
+    // was removed in the branch never comes back, but its cell may have been
+    // reused for another one: compare the serials.
+    vector<Common> const &before = d_dominators.top();
+    for (size_t idx = d_context.common.size(); idx--; )
+    {
+        bool dominates = false;
+        for (size_t jdx = 0; jdx != before.size(); ++jdx)
+            dominates |= before[jdx].serial == d_context.common[idx].serial;
+        
+        if (!dominates)
+        {
+            d_context.memory[d_context.common[idx].result] = s_oldId;
+            d_context.common.erase(d_context.common.begin() + idx);
+        }
+    }
+}
+
+void Parser::forgetAll()
+{
+    // Control flow: results computed so far may not have been computed on
+    // every path leading here
+    for (size_t idx = 0; idx != d_context.common.size(); ++idx)
+        d_context.memory[d_context.common[idx].result] = s_oldId;
+    d_context.common.clear();
 }
 
 int Parser::call(string const &funName, vector<int> const &args)
 {
-    if (find(s_functionVec.begin(), s_functionVec.end(), funName) != s_functionVec.end())
+    Trace trace(*this, "call");
+    forgetAll();
+    
+    if (d_context.shared.find(funName) != d_context.shared.end())
+        return callShared(funName, args);
+    
+    if (find(d_context.functionVec.begin(), d_context.functionVec.end(), funName) != d_context.functionVec.end())
         throw string("Error: recursion is not supported.");
     
     // Create a new parser to parse this function
-    Parser subParser(d_preprocessor, funName, d_out, args);
+    Parser subParser(d_context, d_preprocessor, funName, d_out, args);
     subParser.parse();
 
     // Store the return value in tmp
@@ -12,33 +12,141 @@
 #include <fstream>
 #include <sstream>
 #include <tuple>
+#include <set>
+#include <chrono>
 #include "../preprocessor/ppparser.h"
+#include "../optimizer/optimizer.h"
 #include "scanner/ccscanner.h"
 
 // $insert namespace-open
 namespace Compiler
 {
 
+struct Target                       // the cells of the interpreter the code will run on
+{
+    int     cellBits;               // 8, 16 or 32
+    bool    wrap;                   // whether 0 - 1 gives the largest value instead of 0
+
+    Target()
+    :
+        cellBits(8),
+        wrap(false)
+    {}
+};
+
+struct Footprint                    // the part of the tape a program uses
+{
+    size_t  cells;                  // highest cell touched + 1
+    bool    bounded;                // false if recursion can take more
+};
+
+struct Origin                       // where a range of the generated code comes from
+{
+    size_t          begin;          // offsets into the code
+    size_t          end;
+    std::string     file;
+    std::string     function;
+    size_t          line;
+    std::string     primitive;      // the Parser member emitting it, empty in between
+};
+
+struct FunctionStats                // of all compiles of a function, see Context::stats
+{
+    size_t  compiles;               // once per inlined call
+    double  seconds;                // not counting the functions it calls
+    size_t  ops;                    // Brainfuck commands emitted, idem
+    size_t  cells;                  // allocated while compiling it
+    size_t  peak;                   // highest cell allocated + 1
+    size_t  collections;            // collectGarbage() runs
+};
+
+struct Stats
+{
+    std::map<std::string, FunctionStats>    functions;
+    std::map<std::string, size_t>           primitives;     // commands emitted, including those
+};                                                          // of the primitives it uses
+
+    // One line per function and per primitive, most commands first
+void writeStats(std::ostream &out, Stats const &stats);
+
+struct Shared                       // a function emitted once, inside the dispatch loop
+{
+    int                 entry;  // block flags
+    int                 exit;
+    std::vector<int>    params;
+    int                 ret;    // -1 for void functions
+    std::vector<int>    sites;  // continuation block of every call, indexed by return id - 1
+};
+
+struct Common                       // an operation whose result can be reused
+{
+    std::string     op;
+    int             lhs;        // operand cells, -2 - value for constants
+    int             rhs;        // -1 for unary operations
+    int             result;
+    size_t          serial;     // unique within a compilation
+};
+
+    // The state of a compilation, shared by all of its Parsers. Compiles
+    // in other threads each need their own.
+struct Context
+{
+    typedef std::vector<std::string> Memory;
+
+    Memory                              memory;
+    int                                 idx;            // the cell the pointer is at
+    std::vector<std::string>            functionVec;
+    std::map<int, std::pair<int, int>>  pointers;       // Holds the indices that point to other memory: idx, #elements
+    std::map<int, int>                  pointed;        // Indices of memory (supposedly) being pointed to and their number of elements
+    std::map<int, int>                  constants;      // Temporaries holding a value that is known at compile-time
+    std::vector<Common>                 common;         // Results available for reuse, oldest first
+    size_t                              serials;        // of the Common entries made so far
+    std::map<int, std::string>          literals;       // String literals not in memory (yet): pointer -> text
+    Target                              target;
+    std::vector<Origin>                 origins;        // source map, begin only while compiling
+    std::vector<Origin>                 tracing;        // primitives being compiled, innermost last
+    Stats                               stats;
+    std::map<std::string, size_t>       primitives;     // number of Traces alive per primitive
+    std::vector<std::pair<double, size_t>> nested;      // seconds and ops of the functions called
+
+    Optimizer::CallGraph                callGraph;
+    std::map<std::string, Shared>       shared;
+    std::string                         sharing;        // shared function being compiled, if any
+    std::set<int>                       touched;        // cells allocated while compiling it
+    std::vector<int>                    scratch;        // used by the return blocks
+    int                                 block;          // flag of the current dispatch block
+    int                                 maxIdx;         // the return stack starts beyond this cell
+
+    explicit Context(size_t memorySize = 30000, Target const &target = Target());
+};
+
 #undef Parser
 class Parser: public ParserBase
 {
-    typedef std::vector<std::string> Memory;
-    // Static Data, shared between all Parser instances
-    
-    static Memory                              s_memory;
-    static int                                 s_idx;
-    static bool                                s_initialized;
-    static std::vector<std::string>            s_functionVec;
-    static std::map<int, std::pair<int, int>>  s_pointers;     // Holds the indices that point to other memory: idx, #elements
-    static std::map<int, int>                  s_pointed;      // Indices of memory (supposedly) being pointed to and their number of elements
+    class Trace                     // attributes the code emitted during its lifetime
+    {                               // to a primitive, see Context::origins
+        Parser      &d_parser;
+        bool        d_outer;        // only a parser's outermost primitive counts
+        char const  *d_primitive;
+        size_t      d_begin;        // in the code, for the stats
+
+        public:
+            Trace(Parser &parser, char const *primitive);
+            ~Trace();
+    };
 
     static std::string const s_tmpId;       // freed at ';'
     static std::string const s_stcId;       // freed at '}'
     static std::string const s_refId;       // freed when not referenced to (anymore)
     static std::string const s_retId;       // freed at the end of a function
+    static std::string const s_pinId;       // never freed
+    static std::string const s_cseId;       // freed when its operands change
+    static std::string const s_oldId;       // freed at ';', but may be read more than once
 
     static size_t const MAX_ARRAY_SIZE;
+    static size_t const MAX_COMMON;
     
+    Context                             &d_context;
     Preprocessor::Parser const          &d_preprocessor;
     Scanner                             d_scanner;
     Preprocessor::Function              d_function;
@@ -46,16 +154,34 @@ class Parser: public ParserBase
     std::istringstream                  *d_streamPtr;
     
     std::stack<std::vector<int>>        d_stack;        // Holds all variables, local to if/for
+    std::stack<std::vector<int>>        d_blocks;       // Block flags of if/for, empty if not split
+    std::vector<bool>                   d_blockMode;    // Which if/for have to be split into blocks
+    size_t                              d_control;      // Number of if/for compiled so far
+    std::vector<bool>                   d_elses;        // Which if/for are an if with an else
+    std::stack<std::vector<Common>>     d_dominators;   // Results available before each if
+    Optimizer::Liveness                 d_liveness;     // When each variable can be freed
+    size_t                              d_statement;    // Number of statements compiled so far
+    size_t                              d_traces;       // Number of Traces alive
+    std::chrono::steady_clock::time_point d_started;    // For the stats
+    size_t                              d_begin;
     
     public:
-        Parser(Preprocessor::Parser const &preprocessor, 
+        Parser(Context &context,
+               Preprocessor::Parser const &preprocessor, 
                std::string const &funName, 
                std::ostream &out, 
-               std::vector<int> const &args = std::vector<int>());
+               std::vector<int> const &args = std::vector<int>(),
+               bool shared = false);
         
         ~Parser();        
         int parse();
-        static void init(size_t maxArraySize = 30000);
+
+            // Starts from a fresh context, which afterwards also holds
+            // which code came from which line and primitive, and the stats
+        static Footprint compile(Context &context,
+                            Preprocessor::Parser const &preprocessor, 
+                            std::ostream &out,
+                            Optimizer::CallGraph const &callGraph);
 
     private:
         void error(char const *msg);    // called on (syntax) errors
@@ -73,6 +199,8 @@ class Parser: public ParserBase
     // Compiler members
         void movePtr(int idx);
         void setValue(int val);
+        void setValues(int idx, std::vector<int> const &values);
+        void addValue(int idx, int cnt, int diff);
 
         int printc(int idx);
         int printd(int idx);
@@ -102,6 +230,7 @@ class Parser: public ParserBase
         int moduloElement(int var, int offset, int val);
         
         int lt(int idx1, int idx2);
+        int wrappingLt(int idx1, int idx2);
         int gt(int idx1, int idx2);
         int le(int idx1, int idx2);
         int ge(int idx1, int idx2);
@@ -111,6 +240,7 @@ class Parser: public ParserBase
         int logicAnd(int idx1, int idx2);
         int logicOr(int idx1, int idx2);
         int logicNot(int idx);
+        int common(std::string const &op, int idx1, int idx2 = -1);
 
         int call(std::string const &funName, std::vector<int> const &args);
         
@@ -120,21 +250,53 @@ class Parser: public ParserBase
         void stopIfElse();
         void startFor(int var, int start, int step, int stop);
         void stopFor();
+
+    // Shared functions (dispatch.cc)
+        void dispatch();
+        int callShared(std::string const &funName, std::vector<int> const &args);
+        bool nextBlockMode();
+        void beginBlock(int flag);
+        void endBlock(int next);
+        void branch(int cond, int yes, int no);
+        void returnBlock(Shared const &shared);
+        void push(int idx);
+        void pop(int idx);
+        void enterStack(int offset);
+        void leaveStack(int offset, int idx);
+        std::vector<int> liveCells(std::vector<int> const &except) const;
+        int reserve(std::string const &tag = s_pinId);
+        static std::string resolveStack(Context &context, std::string const &code);
         
     // Helper functions
         void collectGarbage();
+        void freeVariable(std::string const &ident);
         int findFreeMemory(int size = 1);
         int getTemp(int size = 1);
+        void startIfZero(int idx);
+        void stopIfZero(int idx);
         int getFlag();
         int allocate(std::string const &ident);
         int allocString(std::string const &str);
+        void storeString(int ptr, std::string const &str);
         int allocArray(std::vector<int> const &list);
         int allocArray(int size, int val = 0);
         void popStack();
         void clear(int idx);
         bool isPointer(int idx);      
+        bool isConstant(int idx, int &value);
+        void invalidate(int idx);
+        int condition(int idx);
+        int operand(int idx);
+        void forget(int idx);
+        void forgetBranch();
+        void forgetAll();
         std::string variable(std::string const &var);
         int getReturnValue();
+        Origin here(char const *primitive) const;
+        void mark();
+        static void endOrigins(Context &context, size_t size);
+        void startStats();
+        void endStats();
 };
 
 // $insert namespace-close
@@ -0,0 +1,382 @@
+#include "ccparser.ih"
+
+// Functions that can't (recursion) or shouldn't (size) be inlined at every
+// call are emitted once. The program then becomes a loop over blocks, each
+// guarded by its own flag:
+//
+//      running[ flag1[- block1 ] flag2[- block2 ] ... ]
+//
+// A block ends by setting the flag of the block that should run next. A
+// call pushes a return id onto a stack beyond all other cells and jumps to
+// the entry block of the function; its exit block pops the id and sets the
+// flag of the block following the call.
+
+Footprint Parser::compile(Context &context, Preprocessor::Parser const &preprocessor, ostream &out, 
+                          Optimizer::CallGraph const &callGraph)
+{
+    context = Context(context.memory.size(), context.target);
+    context.callGraph = callGraph;
+
+    ostringstream code;
+    if (callGraph.shared().empty())
+    {
+        Parser(context, preprocessor, "main", code).parse();
+        out << code.str();
+        endOrigins(context, code.str().size());
+        return Footprint{static_cast<size_t>(context.maxIdx) + 1, true};
+    }
+
+    {
+        Parser parser(context, preprocessor, "main", code);
+        parser.dispatch();
+    }
+
+    string resolved = resolveStack(context, code.str());
+    out << resolved;
+    endOrigins(context, resolved.size());
+    
+    // Beyond the cells, the stack has a sentinel and a pair for every nested
+    // call. Pushing touches one more pair.
+    size_t calls = 0;
+    bool bounded = callGraph.depth(calls);
+    return Footprint{static_cast<size_t>(context.maxIdx) + 2 + 2 * (calls + 1), bounded};
+}
+
+void Parser::dispatch()
+{
+    int running = reserve();
+    int start = reserve();
+    for (int idx = 0; idx != 3; ++idx)
+        d_context.scratch.push_back(reserve());
+
+    // 1. Reserve the cells through which the shared functions are called
+    set<string> const &names = d_context.callGraph.shared();
+    for (auto it = names.begin(); it != names.end(); ++it)
+    {
+        Preprocessor::Function const &function = d_preprocessor.function(*it);
+        Shared &shared = d_context.shared[*it];
+        string prefix = string("__") + *it + "__";
+
+        shared.entry = reserve();
+        shared.exit = reserve();
+        for (size_t idx = 0; idx != function.args.size(); ++idx)
+            shared.params.push_back(reserve(prefix + function.args[idx]));
+        shared.ret = function.ret == "__void__" ? -1 : reserve(prefix + function.ret);
+    }
+
+    movePtr(running);
+    d_out << "+";
+    movePtr(start);
+    d_out << "+";
+    movePtr(running);
+    d_out << "[";
+
+    // 2. Compile the shared functions first and pin every cell they used,
+    //    so nothing compiled later can overwrite their frames
+    for (auto it = names.begin(); it != names.end(); ++it)
+    {
+        Shared &shared = d_context.shared[*it];
+        d_context.sharing = *it;
+        d_context.touched.clear();
+        {
+            Parser parser(d_context, d_preprocessor, *it, d_out, vector<int>(), true);
+            parser.parse();
+            if (shared.ret != -1 && isPointer(shared.ret))
+                throw string("Error: shared function ") + *it + " can not return an array.";
+            parser.endBlock(shared.exit);
+        }
+
+        // Temporaries of its last statement are still tagged, but every
+        // call writes them again: pin those as well
+        for (auto idx = d_context.touched.begin(); idx != d_context.touched.end(); ++idx)
+            d_context.memory[*idx] = s_pinId;
+        for (size_t idx = 0; idx != shared.params.size(); ++idx)
+            d_context.memory[shared.params[idx]] = s_pinId;
+        if (shared.ret != -1)
+            d_context.memory[shared.ret] = s_pinId;
+
+        movePtr(running);
+    }
+    d_context.sharing.clear();
+
+    // 3. Main, which stops the loop when it's done
+    beginBlock(start);
+    parse();
+    movePtr(running);
+    d_out << "-";
+    endBlock(-1);
+
+    // 4. Now that all calls are known, the exit blocks can return to them
+    for (auto it = names.begin(); it != names.end(); ++it)
+        returnBlock(d_context.shared[*it]);
+
+    movePtr(running);
+    d_out << "]";
+}
+
+int Parser::callShared(string const &funName, vector<int> const &args)
+{
+    Shared &shared = d_context.shared[funName];
+
+    for (size_t idx = 0; idx != args.size(); ++idx)
+    {
+        if (!isPointer(args[idx]))
+            continue;
+        
+        // Arrays live at compile-time addresses: inline this call after all
+        if (d_context.callGraph.reaches(funName, funName))
+            throw string("Error: arrays can not be passed to recursive function ") + funName + ".";
+
+        Parser subParser(d_context, d_preprocessor, funName, d_out, args);
+        subParser.parse();
+        return subParser.getReturnValue();
+    }
+
+    if (args.size() != shared.params.size())
+        throw string("Argument mismatch.");
+
+    // If the callee can end up calling the function being compiled, it will
+    // overwrite its cells: save them on the stack
+    vector<int> values = args;
+    vector<int> saved;
+    if (!d_context.sharing.empty() && d_context.callGraph.reaches(funName, d_context.sharing))
+    {
+        for (size_t idx = 0; idx != args.size(); ++idx)
+        {
+            values[idx] = getTemp();
+            assign(values[idx], args[idx]);
+        }
+
+        saved = liveCells(values);
+        for (size_t idx = 0; idx != saved.size(); ++idx)
+            push(saved[idx]);
+    }
+
+    for (size_t idx = 0; idx != values.size(); ++idx)
+        assign(shared.params[idx], values[idx]);
+
+    int id = getTemp();
+    movePtr(id);
+    setValue(shared.sites.size() + 1);
+    push(id);
+
+    int next = reserve();
+    shared.sites.push_back(next);
+    endBlock(shared.entry);
+    beginBlock(next);
+
+    // Copy the return value before restoring, the callee may be this function
+    int ret = 0;
+    if (shared.ret != -1)
+    {
+        ret = getTemp();
+        assign(ret, shared.ret);
+    }
+
+    for (size_t idx = saved.size(); idx-- != 0; )
+        pop(saved[idx]);
+
+    return ret;
+}
+
+bool Parser::nextBlockMode()
+{
+    size_t idx = d_control++;
+    return idx < d_blockMode.size() && d_blockMode[idx];
+}
+
+void Parser::beginBlock(int flag)
+{
+    movePtr(flag);
+    d_out << "[-";
+    d_context.block = flag;
+}
+
+void Parser::endBlock(int next)
+{
+    if (next != -1)
+    {
+        movePtr(next);
+        d_out << "+";
+    }
+
+    movePtr(d_context.block);
+    d_out << "]";
+}
+
+void Parser::branch(int cond, int yes, int no)
+{
+    int tmp = getTemp();
+    assign(tmp, cond);
+
+    movePtr(no);
+    d_out << "+";
+    movePtr(tmp);
+    d_out << "[[-]";
+    movePtr(yes);
+    d_out << "+";
+    movePtr(no);
+    d_out << "-";
+    movePtr(tmp);
+    d_out << "]";
+
+    endBlock(-1);
+}
+
+void Parser::returnBlock(Shared const &shared)
+{
+    int id   = d_context.scratch[0];
+    int tmp  = d_context.scratch[1];
+    int zero = d_context.scratch[2];
+    size_t count = shared.sites.size();
+
+    beginBlock(shared.exit);
+    pop(id);
+
+    // Count the id down, jumping to the call site at which it hits zero
+    for (size_t site = 0; site != count; ++site)
+    {
+        movePtr(id);
+        d_out << "-";
+        movePtr(zero);
+        d_out << "+";
+        movePtr(id);
+        d_out << "[-";
+        movePtr(tmp);
+        d_out << "+";
+        movePtr(zero);
+        d_out << "[-]";
+        movePtr(id);
+        d_out << "]";
+        movePtr(tmp);
+        d_out << "[-";
+        movePtr(id);
+        d_out << "+";
+        movePtr(tmp);
+        d_out << "]";
+        movePtr(zero);
+        d_out << "[-";
+        movePtr(shared.sites[site]);
+        d_out << "+";
+        movePtr(id);
+        d_out << string(count + 1, '+');    // can't reach zero again
+        movePtr(zero);
+        d_out << "]";
+    }
+
+    movePtr(id);
+    d_out << "[-]";
+    endBlock(-1);
+}
+
+// The stack is a zero sentinel followed by (1, value) pairs, the top being
+// the first pair. Pushing and popping shift all pairs, after which the
+// pointer returns to the sentinel.
+
+void Parser::push(int idx)
+{
+    enterStack(0);
+    d_out << ">>[>>]<<[>[->>+<<]<[->>+<<]<<]>>+";
+    leaveStack(2, idx);
+    d_out << "[-";
+    enterStack(3);
+    d_out << "+";
+    leaveStack(3, idx);
+    d_out << "]";
+}
+
+void Parser::pop(int idx)
+{
+    movePtr(idx);
+    d_out << "[-]";
+    enterStack(3);
+    d_out << "[-";
+    leaveStack(3, idx);
+    d_out << "+";
+    enterStack(3);
+    d_out << "]<[-]>>[[-<<+>>]>[-<<+>>]>]<<<<[<<]";
+    leaveStack(0, idx);
+}
+
+// The address of the stack is only known after compilation, these markers
+// are replaced by resolveStack()
+
+void Parser::enterStack(int offset)
+{
+    d_out << '\x01' << d_context.idx << ',' << offset << '\x01';
+}
+
+void Parser::leaveStack(int offset, int idx)
+{
+    d_out << '\x02' << offset << ',' << idx << '\x02';
+    d_context.idx = idx;
+}
+
+string Parser::resolveStack(Context &context, string const &code)
+{
+    int base = context.maxIdx + 1;
+    string ret;
+    size_t origin = 0;          // origins before it have been moved to ret
+
+    for (size_t pos = 0; pos != code.size(); ++pos)
+    {
+        for (; origin != context.origins.size() && context.origins[origin].begin <= pos; ++origin)
+            context.origins[origin].begin = ret.size();
+
+        char ch = code[pos];
+        if (ch != '\x01' && ch != '\x02')
+        {
+            ret += ch;
+            continue;
+        }
+
+        size_t end = code.find(ch, pos + 1);
+        istringstream marker(code.substr(pos + 1, end - pos - 1));
+        int first;
+        int second;
+        char comma;
+        marker >> first >> comma >> second;
+
+        if (ch == '\x01')       // from cell first to base + second
+            ret += string(base + second - first, '>');
+        else                    // from base + first to cell second
+            ret += string(base + first - second, '<');
+
+        pos = end;
+    }
+
+    for (; origin != context.origins.size(); ++origin)
+        context.origins[origin].begin = ret.size();
+    return ret;
+}
+
+vector<int> Parser::liveCells(vector<int> const &except) const
+{
+    Shared const &self = d_context.shared.find(d_context.sharing)->second;
+    set<int> cells(d_context.touched);
+    cells.insert(self.params.begin(), self.params.end());
+    if (self.ret != -1)
+        cells.insert(self.ret);
+
+    vector<int> live;
+    for (auto it = cells.begin(); it != cells.end(); ++it)
+    {
+        string const &tag = d_context.memory[*it];
+        if (!tag.empty() && tag != s_pinId && find(except.begin(), except.end(), *it) == except.end())
+            live.push_back(*it);
+    }
+
+    return live;
+}
+
+int Parser::reserve(string const &tag)
+{
+    // Flags are tested on every pass through the loop, so they must be zero
+    // until set: take a cell that no code has touched yet
+    int idx = ++d_context.maxIdx;
+    if (idx >= (int)d_context.memory.size())
+        throw string("Out of memory!");
+
+    d_context.memory[idx] = tag;
+    return idx;
+}
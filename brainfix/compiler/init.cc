@@ -1,23 +1,20 @@
 #include "ccparser.ih"
 
-Parser::Memory                      Parser::s_memory(0);
-int                                 Parser::s_idx = 0;
-bool                                Parser::s_initialized = false;
-std::vector<std::string>            Parser::s_functionVec;
 std::string const                   Parser::s_tmpId = "__temp__";         // freed at ';'
 std::string const                   Parser::s_stcId = "__stack__";        // freed at '}'
 std::string const                   Parser::s_refId = "__refd__";         // freed when not referenced to (anymore)
-std::map<int, std::pair<int, int>>  Parser::s_pointers;     // Holds the indices that point to other memory: idx, #elements
-std::map<int, int>                  Parser::s_pointed;      // Indices of memory (supposedly) being pointed to and their number of elements
+std::string const                   Parser::s_pinId = "__pinned__";       // never freed
+std::string const                   Parser::s_cseId = "__common__";       // freed when its operands change
+std::string const                   Parser::s_oldId = "__outdated__";     // freed at ';', but may be read more than once
 size_t const                        Parser::MAX_ARRAY_SIZE = 256;
+size_t const                        Parser::MAX_COMMON = 16;
 
-void Parser::init(size_t memorySize)
-{
-    if (not s_initialized)
-    {
-        s_memory.resize(memorySize);
-        s_initialized = true;
-    }
-    else
-        throw std::string("Warning: multiple calles of Parser::init() ignored.");
-}
\ No newline at end of file
+Context::Context(size_t memorySize, Target const &target)
+:
+    memory(memorySize),
+    idx(0),
+    serials(0),
+    target(target),
+    block(-1),
+    maxIdx(0)
+{}
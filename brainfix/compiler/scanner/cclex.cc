@@ -642,7 +642,7 @@ size_t ScannerBase::matched__(size_t ch)
 
     determineMatchedSize(final);
 
-    d_atBOL = *d_matched.rbegin() == '\n';
+    d_atBOL = !d_matched.empty() && *d_matched.rbegin() == '\n';   // patched, see lexer
 
 
     return final.rule;
@@ -0,0 +1,73 @@
+#include "ccparser.ih"
+
+// While a primitive is compiled, all code it emits is attributed to it and
+// to the line being parsed: the context's origins get an entry wherever the
+// attribution changes. Primitives called by other primitives don't count, except in
+// inlined functions, which have their own Parser.
+
+Parser::Trace::Trace(Parser &parser, char const *primitive)
+:
+    d_parser(parser),
+    d_outer(parser.d_traces++ == 0),
+    d_primitive(primitive),
+    d_begin(parser.d_out.tellp())
+{
+    ++d_parser.d_context.primitives[primitive];
+    if (!d_outer)
+        return;
+
+    d_parser.d_context.tracing.push_back(d_parser.here(primitive));
+    d_parser.mark();
+}
+
+Parser::Trace::~Trace()
+{
+    --d_parser.d_traces;
+    if (--d_parser.d_context.primitives[d_primitive] == 0)   // don't count it twice when nested
+        d_parser.d_context.stats.primitives[d_primitive] += static_cast<size_t>(d_parser.d_out.tellp()) - d_begin;
+    if (!d_outer)
+        return;
+
+    d_parser.d_context.tracing.pop_back();
+    d_parser.mark();
+}
+
+Origin Parser::here(char const *primitive) const
+{
+    return Origin{0, 0, d_function.file, d_function.name, 
+                  d_function.line + d_scanner.lineNr() - 1, primitive};
+}
+
+    // From the current position on, code comes from the innermost primitive
+    // being compiled, or from this parser's function itself
+void Parser::mark()
+{
+    Origin origin = d_context.tracing.empty() ? here("") : d_context.tracing.back();
+    origin.begin = d_out.tellp();
+    
+    if (!d_context.origins.empty() && d_context.origins.back().begin == origin.begin)
+        d_context.origins.pop_back();           // nothing came from it
+    d_context.origins.push_back(origin);
+}
+
+    // Every range ends where the next one begins. Empty ranges are dropped,
+    // consecutive ones with the same origin merged.
+void Parser::endOrigins(Context &context, size_t size)
+{
+    vector<Origin> origins;
+    for (size_t idx = 0; idx != context.origins.size(); ++idx)
+    {
+        Origin origin = context.origins[idx];
+        origin.end = idx + 1 == context.origins.size() ? size : context.origins[idx + 1].begin;
+        if (origin.begin == origin.end)
+            continue;
+
+        if (!origins.empty() && origins.back().line == origin.line &&
+            origins.back().primitive == origin.primitive &&
+            origins.back().function == origin.function && origins.back().file == origin.file)
+            origins.back().end = origin.end;
+        else
+            origins.push_back(origin);
+    }
+    context.origins.swap(origins);
+}
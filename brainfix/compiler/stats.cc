@@ -0,0 +1,71 @@
+#include "ccparser.ih"
+#include <iomanip>
+
+    // Functions are compiled inside their callers: what the functions they
+    // call take is collected in nested and subtracted at the end.
+void Parser::startStats()
+{
+    d_started = chrono::steady_clock::now();
+    d_begin = d_out.tellp();
+    d_context.nested.push_back(make_pair(0.0, 0));
+}
+
+void Parser::endStats()
+{
+    chrono::duration<double> seconds = chrono::steady_clock::now() - d_started;
+    size_t ops = static_cast<size_t>(d_out.tellp()) - d_begin;
+
+    FunctionStats &stats = d_context.stats.functions[d_function.name];
+    ++stats.compiles;
+    stats.seconds += seconds.count() - d_context.nested.back().first;
+    stats.ops += ops - d_context.nested.back().second;
+
+    d_context.nested.pop_back();
+    if (!d_context.nested.empty())
+    {
+        d_context.nested.back().first += seconds.count();
+        d_context.nested.back().second += ops;
+    }
+}
+
+void Compiler::writeStats(ostream &out, Stats const &stats)
+{
+    vector<pair<string, FunctionStats>> functions(stats.functions.begin(), stats.functions.end());
+    stable_sort(functions.begin(), functions.end(),
+        [](pair<string, FunctionStats> const &lhs, pair<string, FunctionStats> const &rhs)
+        {
+            return lhs.second.ops > rhs.second.ops;
+        });
+
+    size_t width = 8;
+    for (auto const &function: functions)
+        width = max(width, function.first.size());
+
+    out << left << setw(width) << "function" << right << setw(10) << "compiles"
+        << setw(12) << "seconds" << setw(12) << "commands" << setw(8) << "cells"
+        << setw(8) << "peak" << setw(10) << "garbage" << '\n';
+    for (auto const &function: functions)
+    {
+        FunctionStats const &entry = function.second;
+        out << left << setw(width) << function.first << right << setw(10) << entry.compiles
+            << setw(12) << fixed << setprecision(4) << entry.seconds << setw(12) << entry.ops
+            << setw(8) << entry.cells << setw(8) << entry.peak << setw(10) << entry.collections
+            << '\n';
+    }
+
+    vector<pair<string, size_t>> primitives(stats.primitives.begin(), stats.primitives.end());
+    stable_sort(primitives.begin(), primitives.end(),
+        [](pair<string, size_t> const &lhs, pair<string, size_t> const &rhs)
+        {
+            return lhs.second > rhs.second;
+        });
+
+    width = 9;
+    for (auto const &primitive: primitives)
+        width = max(width, primitive.first.size());
+
+    out << '\n' << left << setw(width) << "primitive" << right << setw(12) << "commands" << '\n';
+    for (auto const &primitive: primitives)
+        out << left << setw(width) << primitive.first << right << setw(12) << primitive.second
+            << '\n';
+}
@@ -0,0 +1,54 @@
+#include "interpreter.ih"
+#include <sstream>
+#include <chrono>
+#include <iomanip>
+
+void Interpreter::benchmark(string const &code, Program const &program, size_t tapeSize,
+                            istream &in, ostream &out, ostream &report)
+{
+    string input((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    string expected;
+
+    char const *names[] = {"naive", "switch", "threaded", "jit"};
+    for (size_t engine = 0; engine != 4; ++engine)
+    {
+        istringstream engineIn(input);
+        ostringstream engineOut;
+
+        auto start = chrono::steady_clock::now();
+        switch (engine)
+        {
+            case 0:
+                program.runNaive(code, tapeSize, engineIn, engineOut);
+                break;
+
+            case 1:
+                program.runSwitch(tapeSize, engineIn, engineOut);
+                break;
+
+            case 2:
+                program.run(tapeSize, engineIn, engineOut);
+                break;
+
+            case 3:
+                if (!Jit(program).run(tapeSize, engineIn, engineOut))
+                {
+                    report << setw(10) << left << names[engine] << "not available\n";
+                    continue;
+                }
+                break;
+        }
+        chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+
+        if (engine == 0)
+            expected = engineOut.str();
+        else if (engineOut.str() != expected)
+            throw string("The ") + names[engine] + " engine's output differs from the naive one's.";
+
+        report << setw(10) << left << names[engine] << fixed << setprecision(3) 
+               << seconds.count() << "s\n";
+    }
+
+    out << expected;
+    out.flush();
+}
@@ -0,0 +1,140 @@
+#ifndef Interpreter_h_included
+#define Interpreter_h_included
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <initializer_list>
+
+namespace Interpreter
+{
+
+struct Op
+{
+    enum Code
+    {
+        ADD,            // arg: amount
+        MOVE,           // arg: distance
+        CLEAR,          // arg: number of cells, offset: the first of them
+        MULTIPLY,       // offset: target cell, arg: factor, current cell unchanged
+        SCAN,           // arg: step, moves until a zero cell
+        OUTPUT,
+        INPUT,
+        OPEN,           // arg: index of the matching CLOSE
+        CLOSE           // arg: index of the matching OPEN
+    };
+
+    Code    code;
+    int     arg;
+    int     offset;
+};
+
+    // What a single Op did while profiling, see Program::profile()
+struct Counts
+{
+    unsigned long long  steps;          // times executed
+    unsigned long long  iterations;     // of the loop it opens or scans
+    unsigned long long  travel;         // cells the head moved
+};
+
+    // Brainfuck translated into larger steps: runs of +- and <> are folded,
+    // and the loops the compiler emits for clearing, copying, multiplying and
+    // scanning become single operations.
+class Program
+{
+    std::vector<Op>     d_ops;
+    std::vector<size_t> d_positions;    // in the code, of every op
+    long long           d_mask;     // of a wrapping cell
+    bool                d_wrap;     // otherwise cells only stop at 0
+
+    public:
+        Program(std::string const &code, int cellBits, bool wrap);  // throws std::string
+            // Threaded code (computed goto) if the compiler supports it
+        void run(size_t tapeSize, std::istream &in, std::ostream &out) const;
+        void runSwitch(size_t tapeSize, std::istream &in, std::ostream &out) const;
+
+            // Executes the code a character at a time, for comparison
+        void runNaive(std::string const &code, size_t tapeSize, std::istream &in, 
+                      std::ostream &out) const;
+            // Runs the program counting the steps of every op
+        std::vector<Counts> profile(size_t tapeSize, std::istream &in, 
+                                    std::ostream &out) const;
+        void writeC(std::ostream &out, size_t tapeSize) const;
+        void writeAsm(std::ostream &out, size_t tapeSize) const;
+        std::vector<Op> const &ops() const;
+        size_t position(size_t op) const;   // of its first character in the code
+        bool wraps() const;
+        long long mask() const;
+
+    private:
+        void add(char ch, size_t &pos, std::string const &code);
+        bool loop(size_t &pos, std::string const &code);
+        void clear();
+        long long fit(long long value) const;
+        static size_t scan(std::vector<long long> const &tape, size_t ptr, int step);
+        std::string cellType() const;
+        void fitAsm(std::ostream &out, std::string const &cell, bool subtracted) const;
+};
+
+    // Runs the program with every engine, writes the output of the last
+    // to out and the times to report. Throws std::string when the
+    // outputs differ.
+void benchmark(std::string const &code, Program const &program, size_t tapeSize,
+               std::istream &in, std::ostream &out, std::ostream &report);
+
+    // Where a range of the code comes from: one key per kind of entry in
+    // the profile report, e.g. source line, function and primitive.
+struct Attribution
+{
+    size_t                      begin;
+    size_t                      end;
+    std::vector<std::string>    keys;
+};
+
+    // Writes for every kind of key the entries with the most steps.
+void profileReport(Program const &program, std::vector<Counts> const &counts,
+                   std::vector<Attribution> const &attributions,
+                   std::vector<std::string> const &kinds, std::ostream &report, 
+                   size_t top = 10);
+
+    // Translates a Program into x86-64 machine code. Cells are the same as
+    // the Program's.
+class Jit
+{
+    enum Register       // numbers in the encoding
+    {
+        RAX = 0,
+        RBX = 3,
+        RDI = 7
+    };
+
+    Program const               &d_program;
+    std::vector<unsigned char>  d_code;
+    std::vector<size_t>         d_offTape;  // rel32 fields to patch with the error exit
+    std::istream                *d_in;
+    std::ostream                *d_out;
+
+    public:
+        explicit Jit(Program const &program);
+
+            // False if there is no JIT on this platform: run the Program
+            // instead. Throws std::string when the program runs off the tape.
+        bool run(size_t tapeSize, std::istream &in, std::ostream &out);
+
+    private:
+        void compile();
+        void add(std::initializer_list<unsigned char> bytes);
+        void add32(int value);
+        void add64(long long value);
+        void checkBounds(unsigned char reg);
+        void fit(bool rax, bool subtracted);
+        void call(long long function);
+        void jump(size_t at, size_t to);
+
+        static void output(Jit *jit, long long value);
+        static long long input(Jit *jit);
+};
+
+}
+
+#endif
@@ -0,0 +1,236 @@
+#include "interpreter.ih"
+
+#if defined(__x86_64__)
+#include <sys/mman.h>
+#include <cstring>
+#endif
+
+Jit::Jit(Program const &program)
+:
+    d_program(program),
+    d_in(0),
+    d_out(0)
+{
+    compile();
+}
+
+bool Jit::run(size_t tapeSize, istream &in, ostream &out)
+{
+#if defined(__x86_64__)
+    void *memory = mmap(0, d_code.size(), PROT_READ | PROT_WRITE, 
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        return false;
+
+    memcpy(memory, d_code.data(), d_code.size());
+    if (mprotect(memory, d_code.size(), PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(memory, d_code.size());
+        return false;
+    }
+
+    d_in = &in;
+    d_out = &out;
+    vector<long long> tape(tapeSize);
+
+    typedef int (*Code)(Jit *, long long *, long long *, long long);
+    int offTape = reinterpret_cast<Code>(memory)(this, tape.data(), tape.data() + tapeSize, 
+                                                 d_program.mask());
+    munmap(memory, d_code.size());
+    out.flush();
+
+    if (offTape)
+        throw string("The program ran off the tape.");
+    return true;
+#else
+    return false;
+#endif
+}
+
+    // Registers: rbx points at the current cell, r12 and r13 at the ends of 
+    // the tape, r14 holds the mask of a wrapping cell and r15 this Jit, for
+    // the I/O functions. Returns 1 in eax when the program runs off the tape.
+void Jit::compile()
+{
+    add({0x53, 0x41, 0x54, 0x41, 0x55,  // push rbx, r12, r13, r14, r15
+         0x41, 0x56, 0x41, 0x57,
+         0x49, 0x89, 0xFF,              // mov r15, rdi
+         0x48, 0x89, 0xF3,              // mov rbx, rsi
+         0x49, 0x89, 0xF4,              // mov r12, rsi
+         0x49, 0x89, 0xD5,              // mov r13, rdx
+         0x49, 0x89, 0xCE});            // mov r14, rcx
+
+    vector<size_t> open;                // just past the je of each OPEN
+    for (Op const &op: d_program.ops())
+    {
+        switch (op.code)
+        {
+            case Op::ADD:
+                add({0x48, 0x81, 0x03});        // add qword [rbx], imm32
+                add32(op.arg);
+                fit(false, op.arg < 0);
+                break;
+
+            case Op::MOVE:
+                add({0x48, 0x81, 0xC3});        // add rbx, imm32
+                add32(op.arg * 8);
+                checkBounds(RBX);
+                break;
+
+            case Op::CLEAR:
+                if (op.arg == 1)
+                {
+                    add({0x48, 0xC7, 0x03, 0, 0, 0, 0});    // mov qword [rbx], 0
+                    break;
+                }
+                add({0x48, 0x8D, 0xBB});        // lea rdi, [rbx + disp32]
+                add32(op.offset * 8);
+                checkBounds(RDI);
+                add({0x48, 0x8D, 0x83});        // lea rax, [rbx + disp32]
+                add32((op.offset + op.arg - 1) * 8);
+                checkBounds(RAX);
+                add({0x31, 0xC0,                // xor eax, eax
+                     0xB9});                    // mov ecx, imm32
+                add32(op.arg);
+                add({0xF3, 0x48, 0xAB});        // rep stosq
+                break;
+
+            case Op::MULTIPLY:
+                add({0x48, 0x8D, 0x83});        // lea rax, [rbx + disp32]
+                add32(op.offset * 8);
+                checkBounds(RAX);
+                add({0x48, 0x8B, 0x0B,          // mov rcx, [rbx]
+                     0x48, 0x69, 0xC9});        // imul rcx, rcx, imm32
+                add32(op.arg);
+                add({0x48, 0x01, 0x08});        // add [rax], rcx
+                fit(true, op.arg < 0);
+                break;
+
+            case Op::SCAN:
+            {
+                size_t loop = d_code.size();
+                add({0x48, 0x83, 0x3B, 0x00,    // cmp qword [rbx], 0
+                     0x0F, 0x84});              // je done
+                add32(0);
+                size_t done = d_code.size();
+                add({0x48, 0x81, 0xC3});        // add rbx, imm32
+                add32(op.arg * 8);
+                checkBounds(RBX);
+                add({0xE9});                    // jmp loop
+                add32(0);
+                jump(d_code.size() - 4, loop);
+                jump(done - 4, d_code.size());
+            }
+            break;
+
+            case Op::OUTPUT:
+                add({0x4C, 0x89, 0xFF,          // mov rdi, r15
+                     0x48, 0x8B, 0x33});        // mov rsi, [rbx]
+                call(reinterpret_cast<long long>(&Jit::output));
+                break;
+
+            case Op::INPUT:
+                add({0x4C, 0x89, 0xFF});        // mov rdi, r15
+                call(reinterpret_cast<long long>(&Jit::input));
+                add({0x48, 0x89, 0x03});        // mov [rbx], rax
+                break;
+
+            case Op::OPEN:
+                add({0x48, 0x83, 0x3B, 0x00,    // cmp qword [rbx], 0
+                     0x0F, 0x84});              // je past the CLOSE
+                add32(0);
+                open.push_back(d_code.size());
+                break;
+
+            case Op::CLOSE:
+                add({0x48, 0x83, 0x3B, 0x00,    // cmp qword [rbx], 0
+                     0x0F, 0x85});              // jne past the OPEN
+                add32(0);
+                jump(d_code.size() - 4, open.back());
+                jump(open.back() - 4, d_code.size());
+                open.pop_back();
+                break;
+        }
+    }
+
+    add({0x31, 0xC0});                  // xor eax, eax
+    size_t exit = d_code.size();
+    add({0x41, 0x5F, 0x41, 0x5E,        // pop r15, r14, r13, r12, rbx
+         0x41, 0x5D, 0x41, 0x5C, 0x5B,
+         0xC3});                        // ret
+
+    size_t offTape = d_code.size();
+    add({0xB8, 1, 0, 0, 0,              // mov eax, 1
+         0xE9});                        // jmp exit
+    add32(0);
+    jump(d_code.size() - 4, exit);
+    for (size_t at: d_offTape)
+        jump(at, offTape);
+}
+
+    // Jumps to the error exit unless reg (RAX, RBX or RDI) points into the tape
+void Jit::checkBounds(unsigned char reg)
+{
+    add({0x4C, 0x39, static_cast<unsigned char>(0xE0 | reg),   // cmp reg, r12
+         0x0F, 0x82});                  // jb
+    d_offTape.push_back(d_code.size());
+    add32(0);
+    add({0x4C, 0x39, static_cast<unsigned char>(0xE8 | reg),   // cmp reg, r13
+         0x0F, 0x83});                  // jae
+    d_offTape.push_back(d_code.size());
+    add32(0);
+}
+
+    // See Program::fit: applied to the cell rbx (or rax) points at
+void Jit::fit(bool rax, bool subtracted)
+{
+    unsigned char reg = rax ? 0x00 : 0x03;
+    if (d_program.wraps())
+        add({0x4C, 0x21, static_cast<unsigned char>(0x30 | reg)});  // and [reg], r14
+    else if (subtracted)
+        add({0x79, 0x07,                // jns past the mov
+             0x48, 0xC7, reg, 0, 0, 0, 0});     // mov qword [reg], 0
+}
+
+void Jit::call(long long function)
+{
+    add({0x48, 0xB8});                  // mov rax, imm64
+    add64(function);
+    add({0xFF, 0xD0});                  // call rax
+}
+
+    // Stores the rel32 at 'at' so it jumps to 'to'
+void Jit::jump(size_t at, size_t to)
+{
+    int rel = static_cast<int>(to) - static_cast<int>(at + 4);
+    for (size_t idx = 0; idx != 4; ++idx)
+        d_code[at + idx] = rel >> (8 * idx);
+}
+
+void Jit::add(initializer_list<unsigned char> bytes)
+{
+    d_code.insert(d_code.end(), bytes);
+}
+
+void Jit::add32(int value)
+{
+    for (size_t idx = 0; idx != 4; ++idx)
+        d_code.push_back(value >> (8 * idx));
+}
+
+void Jit::add64(long long value)
+{
+    for (size_t idx = 0; idx != 8; ++idx)
+        d_code.push_back(value >> (8 * idx));
+}
+
+void Jit::output(Jit *jit, long long value)
+{
+    jit->d_out->put(static_cast<char>(value));
+}
+
+long long Jit::input(Jit *jit)
+{
+    int ch = jit->d_in->get();
+    return ch == EOF ? 0 : ch;
+}
@@ -0,0 +1,63 @@
+#include "interpreter.ih"
+
+void Program::runNaive(string const &code, size_t tapeSize, istream &in, ostream &out) const
+{
+    vector<size_t> match(code.size());
+    vector<size_t> open;
+    for (size_t pc = 0; pc != code.size(); ++pc)
+    {
+        if (code[pc] == '[')
+            open.push_back(pc);
+        else if (code[pc] == ']')
+        {
+            match[pc] = open.back();
+            match[open.back()] = pc;
+            open.pop_back();
+        }
+    }
+
+    vector<long long> tape(tapeSize);
+    size_t ptr = 0;
+    for (size_t pc = 0; pc != code.size(); ++pc)
+    {
+        switch (code[pc])
+        {
+            case '+':
+                tape[ptr] = fit(tape[ptr] + 1);
+                break;
+
+            case '-':
+                tape[ptr] = fit(tape[ptr] - 1);
+                break;
+
+            case '>':
+            case '<':
+                ptr += code[pc] == '>' ? 1 : -1;
+                if (ptr >= tapeSize)
+                    throw string("The program ran off the tape.");
+                break;
+
+            case '.':
+                out.put(static_cast<char>(tape[ptr]));
+                break;
+
+            case ',':
+            {
+                int ch = in.get();
+                tape[ptr] = ch == EOF ? 0 : fit(ch);
+            }
+            break;
+
+            case '[':
+                if (tape[ptr] == 0)
+                    pc = match[pc];
+                break;
+
+            case ']':
+                if (tape[ptr] != 0)
+                    pc = match[pc];
+                break;
+        }
+    }
+    out.flush();
+}
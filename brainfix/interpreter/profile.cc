@@ -0,0 +1,90 @@
+#include "interpreter.ih"
+
+    // The switch engine, counting as it goes. Loops folded into a CLEAR or
+    // MULTIPLY count as a single step, a SCAN as one iteration per cell.
+vector<Counts> Program::profile(size_t tapeSize, istream &in, ostream &out) const
+{
+    vector<Counts> counts(d_ops.size(), Counts{0, 0, 0});
+    vector<long long> tape(tapeSize);
+    size_t ptr = 0;
+
+    for (size_t pc = 0; pc != d_ops.size(); ++pc)
+    {
+        Op const &op = d_ops[pc];
+        Counts &count = counts[pc];
+        ++count.steps;
+        switch (op.code)
+        {
+            case Op::ADD:
+                tape[ptr] = fit(tape[ptr] + op.arg);
+                break;
+
+            case Op::MOVE:
+                ptr += op.arg;
+                if (ptr >= tapeSize)    // also catches moving left of 0
+                    throw string("The program ran off the tape.");
+                count.travel += abs(op.arg);
+                break;
+
+            case Op::CLEAR:
+                if (op.arg == 1)
+                    tape[ptr] = 0;
+                else
+                {
+                    size_t first = ptr + op.offset;
+                    if (first >= tapeSize || first + op.arg > tapeSize)
+                        throw string("The program ran off the tape.");
+                    fill_n(tape.begin() + first, op.arg, 0);
+                }
+                break;
+
+            case Op::MULTIPLY:
+            {
+                size_t target = ptr + op.offset;
+                if (target >= tapeSize)
+                    throw string("The program ran off the tape.");
+                if (tape[ptr] != 0)
+                    tape[target] = fit(tape[target] + tape[ptr] * op.arg);
+            }
+                break;
+
+            case Op::SCAN:
+            {
+                size_t from = ptr;
+                ptr = scan(tape, ptr, op.arg);
+                size_t distance = ptr > from ? ptr - from : from - ptr;
+                count.travel += distance;
+                count.iterations += distance / abs(op.arg);
+            }
+                break;
+
+            case Op::OUTPUT:
+                out.put(static_cast<char>(tape[ptr]));
+                break;
+
+            case Op::INPUT:
+            {
+                int ch = in.get();
+                tape[ptr] = ch == EOF ? 0 : fit(ch);
+            }
+                break;
+
+            case Op::OPEN:              // iterations are counted here
+                if (tape[ptr] == 0)
+                    pc = op.arg;
+                else
+                    ++count.iterations;
+                break;
+
+            case Op::CLOSE:
+                if (tape[ptr] != 0)
+                {
+                    pc = op.arg;
+                    ++counts[pc].iterations;
+                }
+                break;
+        }
+    }
+    out.flush();
+    return counts;
+}
@@ -0,0 +1,66 @@
+#include "interpreter.ih"
+#include <iomanip>
+
+namespace
+{
+    void add(Counts &total, Counts const &counts)
+    {
+        total.steps += counts.steps;
+        total.iterations += counts.iterations;
+        total.travel += counts.travel;
+    }
+}
+
+void Interpreter::profileReport(Program const &program, vector<Counts> const &counts,
+                                vector<Attribution> const &attributions,
+                                vector<string> const &kinds, ostream &report, size_t top)
+{
+    vector<map<string, Counts>> totals(kinds.size());
+    Counts all{0, 0, 0};
+
+    size_t range = 0;       // ops and ranges are both in the order of the code
+    for (size_t op = 0; op != counts.size(); ++op)
+    {
+        size_t pos = program.position(op);
+        while (range != attributions.size() && attributions[range].end <= pos)
+            ++range;
+        bool known = range != attributions.size() && attributions[range].begin <= pos;
+
+        add(all, counts[op]);
+        for (size_t kind = 0; kind != kinds.size(); ++kind)
+        {
+            string const &key = known ? attributions[range].keys[kind] : "?";
+            Counts &total = totals[kind].insert(make_pair(key, Counts{0, 0, 0})).first->second;
+            add(total, counts[op]);
+        }
+    }
+
+    report << "Executed " << all.steps << " steps and " << all.iterations
+           << " loop iterations, the head travelled " << all.travel << " cells\n";
+
+    for (size_t kind = 0; kind != kinds.size(); ++kind)
+    {
+        vector<pair<string, Counts>> entries(totals[kind].begin(), totals[kind].end());
+        stable_sort(entries.begin(), entries.end(),
+            [](pair<string, Counts> const &lhs, pair<string, Counts> const &rhs)
+            {
+                return lhs.second.steps > rhs.second.steps;
+            });
+        if (entries.size() > top)
+            entries.resize(top);
+
+        size_t width = kinds[kind].size();
+        for (auto const &entry: entries)
+            width = max(width, entry.first.size());
+
+        report << '\n' << left << setw(width) << kinds[kind] << right
+               << setw(14) << "steps" << setw(7) << "%"
+               << setw(14) << "iterations" << setw(14) << "travel" << '\n';
+        for (auto const &entry: entries)
+            report << left << setw(width) << entry.first << right
+                   << setw(14) << entry.second.steps << setw(7) << fixed << setprecision(1)
+                   << (all.steps == 0 ? 0.0 : 100.0 * entry.second.steps / all.steps)
+                   << setw(14) << entry.second.iterations << setw(14) << entry.second.travel
+                   << '\n';
+    }
+}
@@ -0,0 +1,194 @@
+#include "interpreter.ih"
+
+Program::Program(string const &code, int cellBits, bool wrap)
+:
+    d_mask((1LL << cellBits) - 1),
+    d_wrap(wrap)
+{
+    vector<size_t> open;
+    size_t pos = 0;
+    while (pos != code.size())
+    {
+        char ch = code[pos];
+        size_t first = pos;     // merged clears keep the position of the first
+        switch (ch)
+        {
+            case '+':
+            case '-':
+            case '>':
+            case '<':
+                add(ch, pos, code);
+                d_positions.resize(d_ops.size(), first);
+                continue;
+            case '.':
+                d_ops.push_back(Op{Op::OUTPUT, 0, 0});
+                break;
+            case ',':
+                d_ops.push_back(Op{Op::INPUT, 0, 0});
+                break;
+            case '[':
+                if (loop(pos, code))
+                {
+                    d_positions.resize(d_ops.size(), first);
+                    continue;
+                }
+                open.push_back(d_ops.size());
+                d_ops.push_back(Op{Op::OPEN, 0, 0});
+                break;
+            case ']':
+                if (open.empty())
+                    throw string("Unmatched ] in the generated code.");
+                d_ops[open.back()].arg = d_ops.size();
+                d_ops.push_back(Op{Op::CLOSE, static_cast<int>(open.back()), 0});
+                open.pop_back();
+                break;
+        }
+        d_positions.resize(d_ops.size(), first);
+        ++pos;
+    }
+
+    if (!open.empty())
+        throw string("Unmatched [ in the generated code.");
+}
+
+vector<Op> const &Program::ops() const
+{
+    return d_ops;
+}
+
+size_t Program::position(size_t op) const
+{
+    return d_positions[op];
+}
+
+bool Program::wraps() const
+{
+    return d_wrap;
+}
+
+long long Program::mask() const
+{
+    return d_mask;
+}
+
+    // Folds a run of + and - (or > and <) into a single ADD (MOVE). On cells
+    // that stop at zero -+ is not the same as nothing, so the run only
+    // continues with the same character.
+void Program::add(char ch, size_t &pos, string const &code)
+{
+    bool move = ch == '>' || ch == '<';
+    char other = move ? '>' + '<' - ch : '+' + '-' - ch;
+    int amount = 0;
+    for (; pos != code.size(); ++pos)
+    {
+        char next = code[pos];
+        if (string("+-<>.,[]").find(next) == string::npos)
+            continue;
+        if (next != ch && (next != other || (!move && !d_wrap)))
+            break;
+        amount += next == '+' || next == '>' ? 1 : -1;
+    }
+
+    if (amount != 0)
+        d_ops.push_back(Op{move ? Op::MOVE : Op::ADD, amount, 0});
+}
+
+    // Recognizes a loop without nested loops or I/O that ends where it
+    // started and decrements the current cell once per iteration:
+    // [-] becomes CLEAR, [->+>++<<] MULTIPLY 1 1, MULTIPLY 2 2, CLEAR.
+    // A loop that only moves, like [>] or [<<], becomes SCAN. On wrapping
+    // cells [+] is a CLEAR as well.
+bool Program::loop(size_t &pos, string const &code)
+{
+    map<int, int> deltas;
+    map<int, int> signs;        // +1, -1 or 0 if both + and - were seen
+    int offset = 0;
+    size_t end = pos + 1;
+    for (; end != code.size() && code[end] != ']'; ++end)
+    {
+        int delta = 0;
+        switch (code[end])
+        {
+            case '>': ++offset; continue;
+            case '<': --offset; continue;
+            case '+': delta = 1; break;
+            case '-': delta = -1; break;
+            case '.':
+            case ',':
+            case '[':
+                return false;
+            default:
+                continue;
+        }
+
+        deltas[offset] += delta;
+        auto sign = signs.find(offset);
+        if (sign == signs.end())
+            signs[offset] = delta;
+        else if (sign->second != delta)
+            sign->second = 0;
+    }
+
+    if (end == code.size())
+        return false;
+
+    if (deltas.empty())
+    {
+        if (offset == 0)
+            return false;
+        d_ops.push_back(Op{Op::SCAN, offset, 0});
+    }
+    else
+    {
+        int counter = deltas[0];
+        bool wrapsToZero = d_wrap && counter == 1 && deltas.size() == 1;
+        if (offset != 0 || (counter != -1 && !wrapsToZero))
+            return false;
+
+        if (!d_wrap)        // saturation makes the order of + and - matter
+        {
+            for (auto const &sign: signs)
+                if (sign.second == 0)
+                    return false;
+        }
+
+        for (auto const &delta: deltas)
+        {
+            if (delta.first != 0 && delta.second != 0)
+                d_ops.push_back(Op{Op::MULTIPLY, delta.second, delta.first});
+        }
+        clear();
+    }
+
+    pos = end + 1;
+    return true;
+}
+
+    // Adds a CLEAR of the current cell, merged with a CLEAR of the cells
+    // next to it: [-]>[-]>[-] becomes MOVE 2, CLEAR 3 cells from offset -2.
+void Program::clear()
+{
+    size_t size = d_ops.size();
+    if (size >= 2 && d_ops[size - 2].code == Op::CLEAR && d_ops[size - 1].code == Op::MOVE)
+    {
+        Op range = d_ops[size - 2];
+        int move = d_ops[size - 1].arg;
+        if (move == range.offset + range.arg || move == range.offset - 1)
+        {
+            range.offset = move == range.offset - 1 ? 0 : range.offset - move;
+            ++range.arg;
+            d_ops.resize(size - 2);
+
+            if (!d_ops.empty() && d_ops.back().code == Op::MOVE)
+                d_ops.back().arg += move;
+            else
+                d_ops.push_back(Op{Op::MOVE, move, 0});
+            if (d_ops.back().arg == 0)
+                d_ops.pop_back();
+
+            d_ops.push_back(range);
+            return;
+        }
+    }
+    d_ops.push_back(Op{Op::CLEAR, 1, 0});
+}
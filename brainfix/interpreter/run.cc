@@ -0,0 +1,100 @@
+#include "interpreter.ih"
+
+void Program::runSwitch(size_t tapeSize, istream &in, ostream &out) const
+{
+    vector<long long> tape(tapeSize);
+    size_t ptr = 0;
+
+    for (size_t pc = 0; pc != d_ops.size(); ++pc)
+    {
+        Op const &op = d_ops[pc];
+        switch (op.code)
+        {
+            case Op::ADD:
+                tape[ptr] = fit(tape[ptr] + op.arg);
+                break;
+
+            case Op::MOVE:
+                ptr += op.arg;
+                if (ptr >= tapeSize)    // also catches moving left of 0
+                    throw string("The program ran off the tape.");
+                break;
+
+            case Op::CLEAR:
+                if (op.arg == 1)
+                    tape[ptr] = 0;
+                else
+                {
+                    size_t first = ptr + op.offset;
+                    if (first >= tapeSize || first + op.arg > tapeSize)
+                        throw string("The program ran off the tape.");
+                    fill_n(tape.begin() + first, op.arg, 0);
+                }
+                break;
+
+            case Op::MULTIPLY:
+            {
+                size_t target = ptr + op.offset;
+                if (target >= tapeSize)
+                    throw string("The program ran off the tape.");
+                if (tape[ptr] != 0)
+                    tape[target] = fit(tape[target] + tape[ptr] * op.arg);
+            }
+                break;
+
+            case Op::SCAN:
+                ptr = scan(tape, ptr, op.arg);
+                break;
+
+            case Op::OUTPUT:
+                out.put(static_cast<char>(tape[ptr]));
+                break;
+
+            case Op::INPUT:
+            {
+                int ch = in.get();
+                tape[ptr] = ch == EOF ? 0 : fit(ch);
+            }
+                break;
+
+            case Op::OPEN:
+                if (tape[ptr] == 0)
+                    pc = op.arg;
+                break;
+
+            case Op::CLOSE:
+                if (tape[ptr] != 0)
+                    pc = op.arg;
+                break;
+        }
+    }
+    out.flush();
+}
+
+    // Wrapping cells keep the low bits. The others stop at 0 but not at the
+    // top: the comparisons generated for them briefly go past the largest value.
+long long Program::fit(long long value) const
+{
+    if (d_wrap)
+        return value & d_mask;
+    return value < 0 ? 0 : value;
+}
+
+    // Finds the first zero cell from ptr on in steps of step. Searching for
+    // it is much faster than stepping cell by cell.
+size_t Program::scan(vector<long long> const &tape, size_t ptr, int step)
+{
+    if (step == 1)
+        ptr = find(tape.begin() + ptr, tape.end(), 0) - tape.begin();
+    else if (step == -1)
+        ptr = tape.rend() - find(tape.rbegin() + (tape.size() - 1 - ptr), tape.rend(), 0) - 1;
+    else
+    {
+        while (ptr < tape.size() && tape[ptr] != 0)
+            ptr += step;
+    }
+
+    if (ptr >= tape.size())     // also catches moving left of 0
+        throw string("The program ran off the tape.");
+    return ptr;
+}
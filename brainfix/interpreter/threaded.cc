@@ -0,0 +1,100 @@
+#include "interpreter.ih"
+
+#if defined(__GNUC__)
+
+    // Every instruction holds the address of the code executing it, so
+    // each one jumps straight to the next instead of through a switch.
+void Program::run(size_t tapeSize, istream &in, ostream &out) const
+{
+    struct Instr
+    {
+        void const  *code;
+        int         arg;
+        int         offset;
+    };
+
+    static void const *const labels[] =     // in the order of Op::Code
+    {
+        &&add, &&move, &&clear, &&multiply, &&scan, &&output, &&input, &&open, &&close
+    };
+
+    vector<Instr> program;
+    program.reserve(d_ops.size() + 1);
+    for (Op const &op: d_ops)
+        program.push_back(Instr{labels[op.code], op.arg, op.offset});
+    program.push_back(Instr{&&end, 0, 0});
+
+    vector<long long> tape(tapeSize);
+    size_t ptr = 0;
+    Instr const *ip = program.data();
+    goto *ip->code;
+
+add:
+    tape[ptr] = fit(tape[ptr] + ip->arg);
+    goto *(++ip)->code;
+
+move:
+    ptr += ip->arg;
+    if (ptr >= tapeSize)        // also catches moving left of 0
+        throw string("The program ran off the tape.");
+    goto *(++ip)->code;
+
+clear:
+    if (ip->arg == 1)
+        tape[ptr] = 0;
+    else
+    {
+        size_t first = ptr + ip->offset;
+        if (first >= tapeSize || first + ip->arg > tapeSize)
+            throw string("The program ran off the tape.");
+        fill_n(tape.begin() + first, ip->arg, 0);
+    }
+    goto *(++ip)->code;
+
+multiply:
+    {
+        size_t target = ptr + ip->offset;
+        if (target >= tapeSize)
+            throw string("The program ran off the tape.");
+        if (tape[ptr] != 0)
+            tape[target] = fit(tape[target] + tape[ptr] * ip->arg);
+    }
+    goto *(++ip)->code;
+
+scan:
+    ptr = Program::scan(tape, ptr, ip->arg);
+    goto *(++ip)->code;
+
+output:
+    out.put(static_cast<char>(tape[ptr]));
+    goto *(++ip)->code;
+
+input:
+    {
+        int ch = in.get();
+        tape[ptr] = ch == EOF ? 0 : fit(ch);
+    }
+    goto *(++ip)->code;
+
+open:
+    if (tape[ptr] == 0)
+        ip = &program[ip->arg];
+    goto *(++ip)->code;
+
+close:
+    if (tape[ptr] != 0)
+        ip = &program[ip->arg];
+    goto *(++ip)->code;
+
+end:
+    out.flush();
+}
+
+#else
+
+void Program::run(size_t tapeSize, istream &in, ostream &out) const
+{
+    runSwitch(tapeSize, in, out);
+}
+
+#endif
@@ -0,0 +1,178 @@
+#include "interpreter.ih"
+
+    // Writes the program as x86-64 assembly (GNU as) for Linux, using
+    // the registers of the Jit: rbx points at the current cell, r12 and
+    // r13 at the ends of the tape and r14 holds the mask of a wrapping
+    // cell. Output is buffered, I/O uses the read and write system calls.
+void Program::writeAsm(ostream &out, size_t tapeSize) const
+{
+    out << "# Build with: as -o prog.o prog.s && ld -o prog prog.o\n"
+           "\n"
+           "    .lcomm tape, " << 8 * tapeSize << "\n"
+           "    .lcomm outbuf, 4096\n"
+           "    .lcomm buffered, 8\n"
+           "    .lcomm inbyte, 1\n"
+           "\n"
+           "    .section .rodata\n"
+           "offTapeMsg:\n"
+           "    .ascii \"The program ran off the tape.\\n\"\n"
+           "\n"
+           "    .text\n"
+           "    .globl _start\n"
+           "_start:\n"
+           "    lea tape(%rip), %rbx\n"
+           "    mov %rbx, %r12\n"
+           "    lea tape+" << 8 * tapeSize << "(%rip), %r13\n"
+           "    movabs $" << d_mask << ", %r14\n";
+
+    for (size_t idx = 0; idx != d_ops.size(); ++idx)
+    {
+        Op const &op = d_ops[idx];
+        switch (op.code)
+        {
+            case Op::ADD:
+                out << "    addq $" << op.arg << ", (%rbx)\n";
+                fitAsm(out, "(%rbx)", op.arg < 0);
+                break;
+
+            case Op::MOVE:
+                out << "    add $" << 8 * op.arg << ", %rbx\n"
+                       "    cmp %r12, %rbx\n"
+                       "    jb offTape\n"
+                       "    cmp %r13, %rbx\n"
+                       "    jae offTape\n";
+                break;
+
+            case Op::CLEAR:
+                if (op.arg == 1)
+                {
+                    out << "    movq $0, (%rbx)\n";
+                    break;
+                }
+                out << "    lea " << 8 * op.offset << "(%rbx), %rdi\n"
+                       "    cmp %r12, %rdi\n"
+                       "    jb offTape\n"
+                       "    lea " << 8 * (op.offset + op.arg - 1) << "(%rbx), %rax\n"
+                       "    cmp %r13, %rax\n"
+                       "    jae offTape\n"
+                       "    xor %eax, %eax\n"
+                       "    mov $" << op.arg << ", %ecx\n"
+                       "    rep stosq\n";
+                break;
+
+            case Op::MULTIPLY:
+                out << "    lea " << 8 * op.offset << "(%rbx), %rax\n"
+                       "    cmp %r12, %rax\n"
+                       "    jb offTape\n"
+                       "    cmp %r13, %rax\n"
+                       "    jae offTape\n"
+                       "    mov (%rbx), %rcx\n"
+                       "    imul $" << op.arg << ", %rcx, %rcx\n"
+                       "    add %rcx, (%rax)\n";
+                fitAsm(out, "(%rax)", op.arg < 0);
+                break;
+
+            case Op::SCAN:
+                out << "1:\n"
+                       "    cmpq $0, (%rbx)\n"
+                       "    je 2f\n"
+                       "    add $" << 8 * op.arg << ", %rbx\n"
+                       "    cmp %r12, %rbx\n"
+                       "    jb offTape\n"
+                       "    cmp %r13, %rbx\n"
+                       "    jae offTape\n"
+                       "    jmp 1b\n"
+                       "2:\n";
+                break;
+
+            case Op::OUTPUT:
+                out << "    mov (%rbx), %rax\n"
+                       "    call putc\n";
+                break;
+
+            case Op::INPUT:
+                out << "    call getc\n"
+                       "    mov %rax, (%rbx)\n";
+                break;
+
+            case Op::OPEN:
+                out << "    cmpq $0, (%rbx)\n"
+                       "    je .Lclose" << idx << "\n"
+                       ".Lopen" << idx << ":\n";
+                break;
+
+            case Op::CLOSE:
+                out << "    cmpq $0, (%rbx)\n"
+                       "    jne .Lopen" << op.arg << "\n"
+                       ".Lclose" << op.arg << ":\n";
+                break;
+        }
+    }
+
+    out << "    xor %edi, %edi\n"
+           "    jmp exit\n"
+           "\n"
+           "offTape:\n"
+           "    call flush\n"
+           "    mov $1, %eax\n"                // write
+           "    mov $2, %edi\n"
+           "    lea offTapeMsg(%rip), %rsi\n"
+           "    mov $30, %edx\n"
+           "    syscall\n"
+           "    mov $1, %edi\n"
+           "\n"
+           "exit:\n"                            // edi: exit status
+           "    push %rdi\n"
+           "    call flush\n"
+           "    pop %rdi\n"
+           "    mov $60, %eax\n"               // exit
+           "    syscall\n"
+           "\n"
+           "putc:\n"                            // al: the character
+           "    mov buffered(%rip), %rcx\n"
+           "    lea outbuf(%rip), %rdx\n"
+           "    mov %al, (%rdx, %rcx)\n"
+           "    inc %rcx\n"
+           "    mov %rcx, buffered(%rip)\n"
+           "    cmp $4096, %rcx\n"
+           "    je flush\n"
+           "    ret\n"
+           "\n"
+           "flush:\n"
+           "    mov buffered(%rip), %rdx\n"
+           "    test %rdx, %rdx\n"
+           "    je 1f\n"
+           "    mov $1, %eax\n"                // write
+           "    mov $1, %edi\n"
+           "    lea outbuf(%rip), %rsi\n"
+           "    syscall\n"
+           "    movq $0, buffered(%rip)\n"
+           "1:\n"
+           "    ret\n"
+           "\n"
+           "getc:\n"                            // rax: the character, 0 at EOF
+           "    call flush\n"
+           "    xor %eax, %eax\n"              // read
+           "    xor %edi, %edi\n"
+           "    lea inbyte(%rip), %rsi\n"
+           "    mov $1, %edx\n"
+           "    syscall\n"
+           "    test %rax, %rax\n"
+           "    jle 1f\n"
+           "    movzbl inbyte(%rip), %eax\n"
+           "    ret\n"
+           "1:\n"
+           "    xor %eax, %eax\n"
+           "    ret\n";
+}
+
+    // See fit()
+void Program::fitAsm(ostream &out, string const &cell, bool subtracted) const
+{
+    if (d_wrap)
+        out << "    and %r14, " << cell << '\n';
+    else if (subtracted)
+        out << "    jns 1f\n"
+               "    movq $0, " << cell << "\n"
+               "1:\n";
+}
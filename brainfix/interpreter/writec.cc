@@ -0,0 +1,117 @@
+#include "interpreter.ih"
+
+    // Writes the program as C over a static tape: loops become while-loops,
+    // the other operations a statement each. Running off the tape ends the
+    // program with an error, like run() does.
+void Program::writeC(ostream &out, size_t tapeSize) const
+{
+    out << "#include <stdio.h>\n"
+           "#include <stdlib.h>\n"
+           "#include <stdint.h>\n"
+           "#include <string.h>\n"
+           "\n"
+           "#define N " << tapeSize << "\n"
+           "\n"
+           "static " << cellType() << " t[N];\n"
+           "\n"
+           "static void offTape(void)\n"
+           "{\n"
+           "    fputs(\"The program ran off the tape.\\n\", stderr);\n"
+           "    exit(1);\n"
+           "}\n"
+           "\n"
+           "int main(void)\n"
+           "{\n"
+           "    size_t i = 0;\n"
+           "    size_t j;\n"
+           "    int ch;\n"
+           "\n";
+
+    string indent(4, ' ');
+    for (Op const &op: d_ops)
+    {
+        switch (op.code)
+        {
+            case Op::ADD:
+                if (op.arg > 0)
+                    out << indent << "t[i] += " << op.arg << ";\n";
+                else if (d_wrap)
+                    out << indent << "t[i] -= " << -op.arg << ";\n";
+                else
+                    out << indent << "t[i] = t[i] > " << -op.arg << " ? t[i] - " 
+                        << -op.arg << " : 0;\n";
+                break;
+
+            case Op::MOVE:
+                out << indent << "i " << (op.arg > 0 ? "+= " : "-= ") << abs(op.arg)
+                    << ";\n" << indent << "if (i >= N) offTape();\n";
+                break;
+
+            case Op::CLEAR:
+                if (op.arg == 1)
+                {
+                    out << indent << "t[i] = 0;\n";
+                    break;
+                }
+                out << indent << "j = i " << (op.offset > 0 ? "+ " : "- ") << abs(op.offset)
+                    << ";\n" << indent << "if (j >= N || j + " << op.arg << " > N) offTape();\n"
+                    << indent << "memset(&t[j], 0, " << op.arg << " * sizeof t[0]);\n";
+                break;
+
+            case Op::MULTIPLY:
+            {
+                string product = op.arg == 1 || op.arg == -1 ? 
+                                    string("t[i]") : "t[i] * " + to_string(abs(op.arg));
+                out << indent << "j = i " << (op.offset > 0 ? "+ " : "- ") << abs(op.offset)
+                    << ";\n" << indent << "if (j >= N) offTape();\n" << indent;
+                if (op.arg > 0)
+                    out << "t[j] += " << product << ";\n";
+                else if (d_wrap)
+                    out << "t[j] -= " << product << ";\n";
+                else
+                    out << "t[j] = t[j] > " << product << " ? t[j] - " << product << " : 0;\n";
+            }
+            break;
+
+            case Op::SCAN:
+                out << indent << "while (t[i])\n"
+                    << indent << "{\n"
+                    << indent << "    i " << (op.arg > 0 ? "+= " : "-= ") << abs(op.arg) << ";\n"
+                    << indent << "    if (i >= N) offTape();\n"
+                    << indent << "}\n";
+                break;
+
+            case Op::OUTPUT:
+                out << indent << "putchar(t[i]);\n";
+                break;
+
+            case Op::INPUT:
+                out << indent << "ch = getchar();\n"
+                    << indent << "t[i] = ch == EOF ? 0 : ch;\n";
+                break;
+
+            case Op::OPEN:
+                out << indent << "while (t[i])\n" << indent << "{\n";
+                indent += "    ";
+                break;
+
+            case Op::CLOSE:
+                indent.resize(indent.size() - 4);
+                out << indent << "}\n";
+                break;
+        }
+    }
+
+    out << "\n"
+           "    return 0;\n"
+           "}\n";
+}
+
+    // Unsigned arithmetic wraps like the cells do, and the cells that stop
+    // at zero get room to go past their largest value (see fit())
+string Program::cellType() const
+{
+    if (!d_wrap)
+        return "unsigned long long";
+    return d_mask == 0xFF ? "uint8_t" : d_mask == 0xFFFF ? "uint16_t" : "uint32_t";
+}
@@ -1,21 +1,237 @@
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
 #include "compiler/ccparser.h"
+#include "optimizer/optimizer.h"
+#include "interpreter/interpreter.h"
+#include "batch/batch.h"
+#include "server/server.h"
+#include <thread>
 using namespace std;
 
 int main(int argc, char **argv) { try
 {
     if (argc < 2)
     {
-        cout << "Syntax: " << argv[0] << " <BrainFix files (.bfx)> <BrainFuck file>\n";
+        cout << "Syntax: " << argv[0] << " [options] <BrainFix files (.bfx)> <BrainFuck file>\n"
+                "Options:\n"
+                "  --unroll=<n>    unroll constant for-loops expanding to at most n nodes (default 64, 0 = off)\n"
+                "  --no-dce        keep unused functions, stores and expressions\n"
+                "  --no-eval       don't evaluate calls with constant arguments at compile-time\n"
+                "  --cache=<dir>   keep the optimized functions in dir and reuse those that\n"
+                "                  didn't change\n"
+                "  --share=<n>     emit a function once instead of inlining it when that saves\n"
+                "                  more than n tokens (default 0 = only recursive functions)\n"
+                "  --cell-bits=<n> cell size of the target interpreter: 8 (default), 16 or 32\n"
+                "  --wrap          the target's cells wrap around: 0 - 1 is the largest value\n"
+                "  --no-wrap       the target's cells stop at 0 (default)\n"
+                "  --tape-size=<n> number of cells of the target's tape (default 30000)\n"
+                "  --header        start the output with a comment on the tape it needs\n"
+                "  --target=<t>    write the program as bf (default), c or asm (x86-64 Linux)\n"
+                "  --run           run the program instead of only writing it to the BrainFuck file\n"
+                "  --jit           with --run: translate it to machine code first (x86-64 only)\n"
+                "  --source-map    with bf: write which code comes from which line to <BrainFuck file>.map\n"
+                "  --benchmark     run the program with every engine and report their times\n"
+                "  --profile       run the program and report the lines, functions and primitives\n"
+                "                  that execute the most steps\n"
+                "  --stats         report the time of every phase and what every function and\n"
+                "                  primitive costs\n"
+                "  --batch=<file>  compile the jobs in a manifest: per line the BrainFix files\n"
+                "                  and the output file of a program\n"
+                "  --jobs=<n>      with --batch: the number of threads (default: one per core)\n"
+                "  --server=<path> keep compiling for clients connecting to the socket at path\n"
+                "  --client=<path> have the server at path compile the program\n";
         return 1;
     }
 
     vector<ifstream*> inputFiles;
+    vector<string> inputNames;
     string outputFileName = "a.bf";
+    Optimizer::Options options;
+    Compiler::Target target;
+    size_t tapeSize = 30000;
+    bool header = false;
+    bool run = false;
+    bool jit = false;
+    bool benchmark = false;
+    bool profile = false;
+    bool stats = false;
+    bool sourceMap = false;
+    string backend = "bf";
+    string manifest;
+    string serverPath;
+    string clientPath;
+    size_t jobs = max(thread::hardware_concurrency(), 1u);
+    
+    // Reads the number of a numeric option, which must be all digits
+    auto number = [](string const &text, size_t &value) -> bool
+    {
+        if (text.empty() || text.find_first_not_of("0123456789") != string::npos)
+            return false;
+        try
+        {
+            value = stoul(text);
+        }
+        catch (out_of_range const &)
+        {
+            return false;
+        }
+        return true;
+    };
+    
     for (int i = 1; i != argc; ++i)
     {
         string fileName = argv[i];
+        if (fileName.compare(0, 9, "--unroll=") == 0)
+        {
+            if (!number(fileName.substr(9), options.unrollBudget))
+            {
+                cout << "--unroll takes a number of nodes.\n";
+                return 1;
+            }
+            continue;
+        }
+        
+        if (fileName.compare(0, 8, "--cache=") == 0)
+        {
+            options.cache = fileName.substr(8);
+            continue;
+        }
+        
+        if (fileName.compare(0, 8, "--share=") == 0)
+        {
+            if (!number(fileName.substr(8), options.shareBudget))
+            {
+                cout << "--share takes a number of tokens.\n";
+                return 1;
+            }
+            continue;
+        }
+        
+        if (fileName.compare(0, 12, "--cell-bits=") == 0)
+        {
+            size_t bits;
+            if (!number(fileName.substr(12), bits) || (bits != 8 && bits != 16 && bits != 32))
+            {
+                cout << "Cells are 8, 16 or 32 bits wide.\n";
+                return 1;
+            }
+            target.cellBits = bits;
+            continue;
+        }
+        
+        if (fileName.compare(0, 8, "--batch=") == 0)
+        {
+            manifest = fileName.substr(8);
+            continue;
+        }
+        
+        if (fileName.compare(0, 9, "--server=") == 0)
+        {
+            serverPath = fileName.substr(9);
+            continue;
+        }
+        
+        if (fileName.compare(0, 9, "--client=") == 0)
+        {
+            clientPath = fileName.substr(9);
+            continue;
+        }
+        
+        if (fileName.compare(0, 7, "--jobs=") == 0)
+        {
+            if (!number(fileName.substr(7), jobs))
+            {
+                cout << "--jobs takes a number of threads.\n";
+                return 1;
+            }
+            jobs = max(jobs, size_t(1));
+            continue;
+        }
+        
+        if (fileName.compare(0, 12, "--tape-size=") == 0)
+        {
+            if (!number(fileName.substr(12), tapeSize))
+            {
+                cout << "--tape-size takes a number of cells.\n";
+                return 1;
+            }
+            continue;
+        }
+        
+        if (fileName.compare(0, 9, "--target=") == 0)
+        {
+            backend = fileName.substr(9);
+            if (backend != "bf" && backend != "c" && backend != "asm")
+            {
+                cout << "The target is bf, c or asm.\n";
+                return 1;
+            }
+            continue;
+        }
+        
+        if (fileName == "--header")
+        {
+            header = true;
+            continue;
+        }
+        
+        if (fileName == "--run")
+        {
+            run = true;
+            continue;
+        }
+        
+        if (fileName == "--jit")
+        {
+            jit = true;
+            continue;
+        }
+        
+        if (fileName == "--source-map")
+        {
+            sourceMap = true;
+            continue;
+        }
+        
+        if (fileName == "--benchmark")
+        {
+            run = benchmark = true;
+            continue;
+        }
+        
+        if (fileName == "--profile")
+        {
+            run = profile = true;
+            continue;
+        }
+        
+        if (fileName == "--stats")
+        {
+            stats = true;
+            continue;
+        }
+        
+        if (fileName == "--wrap" || fileName == "--no-wrap")
+        {
+            target.wrap = fileName == "--wrap";
+            continue;
+        }
+        
+        if (fileName == "--no-dce")
+        {
+            options.deadCode = false;
+            continue;
+        }
+        
+        if (fileName == "--no-eval")
+        {
+            options.evaluate = false;
+            continue;
+        }
+        
         size_t pos = fileName.find_last_of('.');
         if (pos == string::npos)
         {
@@ -25,7 +241,10 @@ int main(int argc, char **argv) { try
         
         string ext = fileName.substr(pos);
         if (ext == ".bfx")
+        {
             inputFiles.push_back(new ifstream(fileName));
+            inputNames.push_back(fileName);
+        }
         else if (outputFileName == "a.bf")
             outputFileName = argv[i];
         else
@@ -35,23 +254,138 @@ int main(int argc, char **argv) { try
         }
     }
     
+    if (!serverPath.empty())
+    {
+        Server::Daemon(serverPath).run();
+        return 0;
+    }
+    
+    if (!manifest.empty())
+    {
+        ifstream manifestFile(manifest);
+        if (!manifestFile)
+            throw "Can't open " + manifest + ".";
+        
+        Batch::Settings settings{options, target, tapeSize, header, backend};
+        return Batch::Builder(manifestFile, settings).run(jobs, cerr) == 0 ? 0 : 1;
+    }
+    
     if (inputFiles.size() < 1)
     {
         cout << "You didn't provide any BrainFix files (*.bfx)!\n";
         return 1;
     }
     
-    ofstream outputFile(outputFileName);
-
+    if (!clientPath.empty())
+    {
+        // The server only sends the output file
+        if (run || stats || sourceMap)
+        {
+            cout << "--client can't be combined with --run, --benchmark, --profile, --stats "
+                    "or --source-map.\n";
+            return 1;
+        }
+        
+        if (backend != "bf" && outputFileName == "a.bf")
+            outputFileName = backend == "c" ? "a.c" : "a.s";
+        
+        // Like --batch, a failed compilation makes for a non-zero exit
+        Batch::Settings settings{options, target, tapeSize, header, backend};
+        try
+        {
+            cout << Server::client(clientPath, settings, inputNames, outputFileName) << '\n';
+        }
+        catch (string const &msg)
+        {
+            cerr << msg << '\n';
+            return 1;
+        }
+        return 0;
+    }
+    
+    // Wall time of every phase, for --stats
+    vector<pair<string, double>> phases;
+    auto started = chrono::steady_clock::now();
+    auto phase = [&](string const &name)
+    {
+        auto now = chrono::steady_clock::now();
+        phases.push_back(make_pair(name, chrono::duration<double>(now - started).count()));
+        started = now;
+    };
+    
     // preprocess all input files
     Preprocessor::Parser prep;
     for (size_t idx = 0; idx != inputFiles.size(); ++idx)
-        if (prep.parse(*inputFiles[idx]))
+        if (prep.parse(*inputFiles[idx], inputNames[idx]))
             return 1;
+    phase("preprocessing");
+
+    Optimizer::optimize(prep, options);
+    phase("optimization");
 
-    Compiler::Parser::init(30000);
-    Compiler::Parser(prep, "main", outputFile).parse();
+    Batch::Settings settings{options, target, tapeSize, header, backend};
+    Compiler::Context context(tapeSize, target);
+    ostringstream code;
+    Compiler::Footprint footprint = Batch::generate(prep, settings, context, code);
+    phase("compilation");       // parsing and emitting happen in one pass
+    
+    // When running, stdout belongs to the program
+    (run ? cerr : cout) << Batch::usage(footprint) << '\n';
+    
+    Interpreter::Program program(code.str(), target.cellBits, target.wrap);
+    phase("translation");
+    
+    // When running, only write the code if a file was named
+    if (!run || outputFileName != "a.bf")
+    {
+        if (backend != "bf" && outputFileName == "a.bf")
+            outputFileName = backend == "c" ? "a.c" : "a.s";
+        
+        ofstream outputFile(outputFileName);
+        size_t start = Batch::write(outputFile, program, code.str(), footprint, settings);
+        
+        // One range of bytes per line: begin end file:line function primitive
+        if (sourceMap && backend == "bf")
+        {
+            ofstream mapFile(outputFileName + ".map");
+            for (Compiler::Origin const &origin: context.origins)
+                mapFile << start + origin.begin << ' ' << start + origin.end << ' ' 
+                        << origin.file << ':' << origin.line << ' ' << origin.function << ' '
+                        << (origin.primitive.empty() ? "-" : origin.primitive) << '\n';
+        }
+    }
+    
+    if (stats)
+    {
+        phase("writing");
+        for (auto const &entry: phases)
+            cerr << left << setw(16) << entry.first << fixed << setprecision(4) 
+                 << entry.second << "s\n";
+        cerr << left << setw(16) << "peak tape" << footprint.cells << " cells\n\n";
+        Compiler::writeStats(cerr, context.stats);
+    }
     
+    if (benchmark)
+        Interpreter::benchmark(code.str(), program, tapeSize, cin, cout, cerr);
+    else if (profile)
+    {
+        vector<Interpreter::Counts> counts = program.profile(tapeSize, cin, cout);
+        
+        vector<Interpreter::Attribution> attributions;
+        for (Compiler::Origin const &origin: context.origins)
+            attributions.push_back(Interpreter::Attribution{origin.begin, origin.end, 
+                {origin.file + ':' + to_string(origin.line), origin.function, 
+                 origin.primitive.empty() ? "-" : origin.primitive}});
+        
+        Interpreter::profileReport(program, counts, attributions, 
+                                   {"line", "function", "primitive"}, cerr);
+    }
+    else if (run)
+    {
+        if (!jit || !Interpreter::Jit(program).run(tapeSize, cin, cout))
+            program.run(tapeSize, cin, cout);
+    }
+
 } catch (std::string const &msg) 
 {
     cerr << msg << '\n';
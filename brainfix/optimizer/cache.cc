@@ -0,0 +1,62 @@
+#include "optimizer.ih"
+#include <fstream>
+#include <thread>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+
+Cache::Cache(string const &directory)
+:
+    d_directory(directory)
+{
+    mkdir(directory.c_str(), 0777);     // fails if it already exists
+}
+
+bool Cache::find(string const &key, string &value) const
+{
+    ifstream in(path(key), ios::binary);
+    size_t size;
+    if (!(in >> size) || in.get() != '\n')
+        return false;
+
+    string stored(size, 0);
+    if (!in.read(&stored[0], size) || stored != key)
+        return false;
+
+    value.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    return true;
+}
+
+    // Written under a name of its own first, so a reader running at the
+    // same time never sees half an entry
+void Cache::store(string const &key, string const &value) const
+{
+    string target = path(key);
+    string temporary = target + '.' + to_string(getpid()) + '.' +
+                       to_string(std::hash<thread::id>()(this_thread::get_id()));
+    ofstream out(temporary, ios::binary);
+    out << key.size() << '\n' << key << value;
+    out.close();
+
+    if (!out || rename(temporary.c_str(), target.c_str()) != 0)
+        remove(temporary.c_str());
+}
+
+string Cache::path(string const &key) const
+{
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", hash(key));
+    return d_directory + '/' + name;
+}
+
+    // FNV-1a
+unsigned long long Cache::hash(string const &text)
+{
+    unsigned long long value = 14695981039346656037ULL;
+    for (unsigned char ch: text)
+    {
+        value ^= ch;
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
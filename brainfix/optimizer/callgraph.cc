@@ -0,0 +1,231 @@
+#include "optimizer.ih"
+
+namespace
+{
+    bool usesArrays(Expr const &expr)
+    {
+        if (expr.kind == Expr::LIST || expr.kind == Expr::NEW_ARRAY ||
+            expr.kind == Expr::STRING || expr.kind == Expr::ELEMENT)
+            return true;
+
+        for (size_t idx = 0; idx != expr.args.size(); ++idx)
+            if (usesArrays(expr.args[idx]))
+                return true;
+
+        return false;
+    }
+
+    bool usesArrays(Stmt const &stmt)
+    {
+        if (stmt.kind == Stmt::PRINTS)
+            return true;
+
+        for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+            if (usesArrays(stmt.exprs[idx]))
+                return true;
+
+        for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+            if (usesArrays(stmt.body[idx]))
+                return true;
+
+        return false;
+    }
+
+    void countCalls(Expr const &expr, map<string, size_t> &count)
+    {
+        if (expr.kind == Expr::CALL)
+            ++count[expr.text];
+
+        for (size_t idx = 0; idx != expr.args.size(); ++idx)
+            countCalls(expr.args[idx], count);
+    }
+
+    void countCalls(Stmt const &stmt, map<string, size_t> &count)
+    {
+        for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+            countCalls(stmt.exprs[idx], count);
+
+        for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+            countCalls(stmt.body[idx], count);
+    }
+}
+
+CallGraph::CallGraph(vector<Preprocessor::Function> const &functions, size_t shareBudget)
+{
+    map<string, size_t> size;
+    map<string, size_t> count;
+    set<string> arrays;
+
+    for (size_t idx = 0; idx != functions.size(); ++idx)
+    {
+        string const &name = functions[idx].name;
+        vector<Stmt> body;
+        try
+        {
+            body = Source(functions[idx].body).parse();
+        }
+        catch (string const &)
+        {
+            continue;
+        }
+
+        set<string> &callees = d_callees[name];
+        for (size_t stmt = 0; stmt != body.size(); ++stmt)
+        {
+            calls(body[stmt], callees);
+            countCalls(body[stmt], count);
+            if (usesArrays(body[stmt]))
+                arrays.insert(name);
+        }
+
+        size[name] = Source::tokenize(functions[idx].body).size();
+    }
+
+    for (auto it = d_callees.begin(); it != d_callees.end(); ++it)
+    {
+        string const &name = it->first;
+        if (name == "main")
+            continue;
+
+        if (reaches(name, name))
+            d_shared.insert(name);      // can't be inlined at all
+        else if (shareBudget != 0 && count[name] > 1 && !arrays.count(name) &&
+                 size[name] * (count[name] - 1) > shareBudget)
+            d_shared.insert(name);
+    }
+
+    // Inlined functions that call a shared one end the block just the same
+    d_splits = d_shared;
+    for (bool changed = true; changed; )
+    {
+        changed = false;
+        for (auto it = d_callees.begin(); it != d_callees.end(); ++it)
+        {
+            if (d_splits.count(it->first))
+                continue;
+
+            for (auto callee = it->second.begin(); callee != it->second.end(); ++callee)
+            {
+                if (d_splits.count(*callee))
+                {
+                    d_splits.insert(it->first);
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+set<string> const &CallGraph::shared() const
+{
+    return d_shared;
+}
+
+bool CallGraph::reaches(string const &from, string const &to) const
+{
+    set<string> seen;
+    vector<string> todo(1, from);
+    while (!todo.empty())
+    {
+        auto it = d_callees.find(todo.back());
+        todo.pop_back();
+        if (it == d_callees.end())
+            continue;
+
+        for (auto callee = it->second.begin(); callee != it->second.end(); ++callee)
+        {
+            if (*callee == to)
+                return true;
+            if (seen.insert(*callee).second)
+                todo.push_back(*callee);
+        }
+    }
+
+    return false;
+}
+
+bool CallGraph::depth(size_t &calls) const
+{
+    // Recursive functions are always shared, so without them the calls form
+    // an acyclic graph
+    for (auto it = d_shared.begin(); it != d_shared.end(); ++it)
+        if (reaches(*it, *it))
+            return false;
+
+    map<string, size_t> memo;
+    calls = depth("main", memo);
+    return true;
+}
+
+size_t CallGraph::depth(string const &name, map<string, size_t> &memo) const
+{
+    auto known = memo.find(name);
+    if (known != memo.end())
+        return known->second;
+
+    size_t deepest = 0;
+    auto it = d_callees.find(name);
+    if (it != d_callees.end())
+        for (auto callee = it->second.begin(); callee != it->second.end(); ++callee)
+            deepest = max(deepest, depth(*callee, memo));
+
+    return memo[name] = deepest + d_shared.count(name);
+}
+
+vector<bool> CallGraph::blockMode(string const &body) const
+{
+    vector<bool> modes;
+    if (d_shared.empty())
+        return modes;
+
+    try
+    {
+        vector<Stmt> stmts = Source(body).parse();
+        for (size_t idx = 0; idx != stmts.size(); ++idx)
+            blockMode(stmts[idx], modes);
+    }
+    catch (string const &)
+    {}
+
+    return modes;
+}
+
+void CallGraph::blockMode(Stmt const &stmt, vector<bool> &modes) const
+{
+    if (stmt.kind == Stmt::IF || stmt.kind == Stmt::FOR)
+    {
+        bool split = false;
+        for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+            split |= splits(stmt.body[idx]);
+        modes.push_back(split);
+    }
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        blockMode(stmt.body[idx], modes);
+}
+
+bool CallGraph::splits(Stmt const &stmt) const
+{
+    for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+        if (splits(stmt.exprs[idx]))
+            return true;
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        if (splits(stmt.body[idx]))
+            return true;
+
+    return false;
+}
+
+bool CallGraph::splits(Expr const &expr) const
+{
+    if (expr.kind == Expr::CALL && d_splits.count(expr.text))
+        return true;
+
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        if (splits(expr.args[idx]))
+            return true;
+
+    return false;
+}
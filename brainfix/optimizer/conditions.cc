@@ -0,0 +1,65 @@
+#include "optimizer.ih"
+
+namespace
+{
+    bool split(Stmt &stmt)
+    {
+        bool changed = splitConditions(stmt.body);
+        if (stmt.kind != Stmt::IF)
+            return changed;
+
+        Expr cond = stmt.exprs[0];
+        if (cond.kind == Expr::NOT && stmt.body.size() == 2)
+        {
+            stmt.exprs[0] = cond.args[0];
+            swap(stmt.body[0], stmt.body[1]);
+        }
+        else if (cond.kind == Expr::BINARY && cond.text == "&&" &&
+                 stmt.body.size() == 1 && DeadCode::pure(cond.args[1]))
+        {
+            stmt.exprs[0] = cond.args[0];
+            stmt.body[0] = Stmt{Stmt::IF, "", {cond.args[1]}, {stmt.body[0]}, stmt.line};
+            split(stmt.body[0]);
+        }
+        else
+            return changed;
+
+        split(stmt);            // the new condition may be split further
+        return true;
+    }
+
+    void elseBranches(Stmt const &stmt, vector<bool> &elses)
+    {
+        if (stmt.kind == Stmt::IF || stmt.kind == Stmt::FOR)
+            elses.push_back(stmt.body.size() == 2);
+
+        for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+            elseBranches(stmt.body[idx], elses);
+    }
+}
+
+bool Optimizer::splitConditions(vector<Stmt> &body)
+{
+    bool changed = false;
+    for (size_t idx = 0; idx != body.size(); ++idx)
+        changed |= split(body[idx]);
+
+    return changed;
+}
+
+vector<bool> Optimizer::elseBranches(string const &body)
+{
+    vector<bool> elses;
+    try
+    {
+        vector<Stmt> stmts = Source(body).parse();
+        for (size_t idx = 0; idx != stmts.size(); ++idx)
+            ::elseBranches(stmts[idx], elses);
+    }
+    catch (string const &)
+    {
+        elses.clear();
+    }
+
+    return elses;
+}
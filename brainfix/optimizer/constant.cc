@@ -0,0 +1,92 @@
+#include "optimizer.ih"
+
+int Optimizer::charValue(string const &literal)
+{
+    if (literal.length() < 4 || literal[1] != '\\')     // 'x'
+        return literal[1];
+
+    switch (literal[2])                                 // '\x', see Compiler::Scanner::escape()
+    {
+        case 'n':
+            return '\n';
+        case 't':
+            return '\t';
+        case 'a':
+            return '\a';
+        case 'f':
+            return '\f';
+        case 'b':
+            return '\b';
+        case 'r':
+            return '\r';
+        default:
+            return literal[2];
+    }
+}
+
+bool Optimizer::constant(Expr const &expr, int &value)
+{
+    switch (expr.kind)
+    {
+        case Expr::NUMBER:
+            value = stoi(expr.text);
+            return true;
+        case Expr::CHAR:
+            value = charValue(expr.text);
+            return true;
+        case Expr::NOT:
+        {
+            int operand;
+            if (!constant(expr.args[0], operand))
+                return false;
+
+            value = !operand;
+            return true;
+        }
+        case Expr::BINARY:
+        {
+            int lhs;
+            int rhs;
+            if (!constant(expr.args[0], lhs) || !constant(expr.args[1], rhs))
+                return false;
+
+            string const &op = expr.text;
+            if (op == "+")
+                value = lhs + rhs;
+            else if (op == "-")
+                value = lhs - rhs;
+            else if (op == "*")
+                value = lhs * rhs;
+            else if (op == "/" || op == "%")
+            {
+                if (rhs == 0)
+                    return false;
+                value = op == "/" ? lhs / rhs : lhs % rhs;
+            }
+            else if (op == "<")
+                value = lhs < rhs;
+            else if (op == ">")
+                value = lhs > rhs;
+            else if (op == "<=")
+                value = lhs <= rhs;
+            else if (op == ">=")
+                value = lhs >= rhs;
+            else if (op == "==")
+                value = lhs == rhs;
+            else if (op == "!=")
+                value = lhs != rhs;
+            else if (op == "&&")
+                value = lhs && rhs;
+            else if (op == "||")
+                value = lhs || rhs;
+            else
+                return false;
+
+            // Outside this range the result depends on the cells of the
+            // target (see Compiler::Target)
+            return value >= 0 && value <= 255;
+        }
+        default:
+            return false;
+    }
+}
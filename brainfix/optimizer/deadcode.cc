@@ -0,0 +1,184 @@
+#include "optimizer.ih"
+
+DeadCode::DeadCode(string const &ret)
+:
+    d_ret(ret)
+{}
+
+bool DeadCode::eliminate(vector<Stmt> &body)
+{
+    // Removing a store may make the variables it read unused: repeat
+    bool changed = false;
+    while (true)
+    {
+        set<string> read;
+        for (size_t idx = 0; idx != body.size(); ++idx)
+            reads(body[idx], read);
+
+        if (!sweep(body, read))
+            return changed;
+
+        changed = true;
+    }
+}
+
+bool DeadCode::sweep(vector<Stmt> &body, set<string> const &read) const
+{
+    bool changed = false;
+    for (size_t idx = 0; idx != body.size(); )
+    {
+        changed |= sweep(body[idx], read);
+
+        if (empty(body[idx]))
+        {
+            body.erase(body.begin() + idx);
+            changed = true;
+        }
+        else
+            ++idx;
+    }
+
+    return changed;
+}
+
+bool DeadCode::sweep(Stmt &stmt, set<string> const &read) const
+{
+    bool changed = false;
+
+    // The loop variable of a for is not an expression: leave it alone
+    size_t first = stmt.kind == Stmt::FOR ? 1 : 0;
+    if (stmt.kind != Stmt::SCAN)
+        for (size_t idx = first; idx != stmt.exprs.size(); ++idx)
+            changed |= strip(stmt.exprs[idx], read);
+
+    // A store at statement level does not need to produce a value
+    if (stmt.kind == Stmt::EXPR && stmt.exprs[0].kind == Expr::ASSIGN &&
+        stmt.exprs[0].text == "=" && dead(stmt.exprs[0].args[0], read))
+    {
+        Expr rvalue = stmt.exprs[0].args[1];
+        stmt.exprs[0] = rvalue;
+        changed = true;
+    }
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        changed |= sweep(stmt.body[idx], read);
+
+    if (stmt.kind == Stmt::BLOCK)
+        changed |= sweep(stmt.body, read);
+
+    int value;
+    if (stmt.kind == Stmt::IF && constant(stmt.exprs[0], value))
+    {
+        // Only one branch can ever be taken
+        Stmt taken{Stmt::BLOCK, "", {}, {}, stmt.line};
+        if (value)
+            taken.body.push_back(stmt.body[0]);
+        else if (stmt.body.size() == 2)
+            taken.body.push_back(stmt.body[1]);
+
+        stmt = taken;
+        return true;
+    }
+
+    return changed;
+}
+
+bool DeadCode::strip(Expr &expr, set<string> const &read) const
+{
+    bool changed = false;
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        changed |= strip(expr.args[idx], read);
+
+    // (x = value) evaluates to value: the store itself can go
+    if (expr.kind == Expr::ASSIGN && expr.text == "=" && dead(expr.args[0], read))
+    {
+        Expr rvalue = expr.args[1];
+        expr = rvalue;
+        return true;
+    }
+
+    return changed;
+}
+
+bool DeadCode::dead(Expr const &lvalue, set<string> const &read) const
+{
+    if (lvalue.text == d_ret || read.count(lvalue.text))
+        return false;
+
+    // The index of an element is still evaluated by the store
+    return lvalue.kind == Expr::VAR || pure(lvalue.args[0]);
+}
+
+void DeadCode::reads(Stmt const &stmt, set<string> &read)
+{
+    // The loop variable of a for is read by the loop's test after every
+    // pass, so it's read for as long as the loop runs
+    if (stmt.kind == Stmt::FOR)
+        read.insert(stmt.exprs[0].text);
+
+    size_t first = stmt.kind == Stmt::FOR ? 1 : 0;
+    if (stmt.kind != Stmt::SCAN)
+        for (size_t idx = first; idx != stmt.exprs.size(); ++idx)
+            reads(stmt.exprs[idx], read);
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        reads(stmt.body[idx], read);
+}
+
+void DeadCode::reads(Expr const &expr, set<string> &read)
+{
+    switch (expr.kind)
+    {
+        case Expr::VAR:
+            read.insert(expr.text);
+            return;
+        case Expr::ELEMENT:
+            read.insert(expr.text);
+            break;
+        case Expr::ASSIGN:
+        {
+            // Storing into a variable does not read it, but a compound
+            // operator does
+            Expr const &lvalue = expr.args[0];
+            if (expr.text != "=")
+                read.insert(lvalue.text);
+            if (lvalue.kind == Expr::ELEMENT)
+                reads(lvalue.args[0], read);
+            reads(expr.args[1], read);
+            return;
+        }
+        default:
+            break;
+    }
+
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        reads(expr.args[idx], read);
+}
+
+bool DeadCode::pure(Expr const &expr)
+{
+    if (expr.kind == Expr::ASSIGN || expr.kind == Expr::CALL)
+        return false;
+
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        if (!pure(expr.args[idx]))
+            return false;
+
+    return true;
+}
+
+bool DeadCode::empty(Stmt const &stmt)
+{
+    switch (stmt.kind)
+    {
+        case Stmt::EXPR:
+            return pure(stmt.exprs[0]);
+        case Stmt::BLOCK:
+            return stmt.body.empty();
+        case Stmt::IF:
+            return pure(stmt.exprs[0]) && empty(stmt.body[0]) &&
+                   (stmt.body.size() == 1 || empty(stmt.body[1]));
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,341 @@
+#include "optimizer.ih"
+
+namespace
+{
+    size_t const MAX_STEPS = 100000;    // per folded call
+    size_t const MAX_DEPTH = 64;
+    size_t const MAX_ARRAY_SIZE = 256;  // see Compiler::Parser
+
+    vector<int> stringValue(string const &literal)     // "..." -> characters and \0
+    {
+        vector<int> cells;
+        for (size_t idx = 1; idx < literal.length() - 1; ++idx)
+        {
+            if (literal[idx] == '\\' && idx + 1 < literal.length() - 1)
+                cells.push_back(charValue(string("'") + literal.substr(idx++, 2) + "'"));
+            else
+                cells.push_back(literal[idx]);
+        }
+
+        cells.push_back(0);
+        return cells;
+    }
+}
+
+Evaluator::Evaluator(vector<Preprocessor::Function> const &functions, vector<vector<Stmt>> const &bodies)
+:
+    d_functions(functions),
+    d_bodies(bodies),
+    d_steps(0)
+{}
+
+bool Evaluator::fold(vector<Stmt> &body)
+{
+    bool changed = false;
+    for (size_t idx = 0; idx != body.size(); ++idx)
+        changed |= fold(body[idx]);
+
+    return changed;
+}
+
+bool Evaluator::fold(Stmt &stmt)
+{
+    bool changed = false;
+    for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+        changed |= fold(stmt.exprs[idx]);
+
+    return fold(stmt.body) || changed;
+}
+
+bool Evaluator::fold(Expr &expr)
+{
+    // Arguments first: they may become literals themselves
+    bool changed = false;
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        changed |= fold(expr.args[idx]);
+
+    if (expr.kind != Expr::CALL)
+        return changed;
+
+    try
+    {
+        // A literal may be out of range as well
+        vector<Value> args(expr.args.size());
+        for (size_t idx = 0; idx != args.size(); ++idx)
+            if (!literal(expr.args[idx], args[idx]))
+                return changed;
+
+        d_steps = MAX_STEPS;
+        expr = expression(call(expr.text, args, 0));
+        return true;
+    }
+    catch (string const &)
+    {
+        return changed;     // impure, too expensive or ill-defined: leave it to run-time
+    }
+}
+
+Evaluator::Value Evaluator::call(string const &name, vector<Value> const &args, size_t depth)
+{
+    if (depth == MAX_DEPTH)
+        throw string("too deep");
+
+    for (size_t fun = 0; fun != d_functions.size(); ++fun)
+    {
+        Preprocessor::Function const &function = d_functions[fun];
+        if (function.name != name)
+            continue;
+
+        if (function.ret == "__void__" || args.size() != function.args.size())
+            throw string("no value");
+
+        Frame frame;
+        for (size_t idx = 0; idx != args.size(); ++idx)
+            frame[function.args[idx]] = args[idx];
+
+        for (size_t stmt = 0; stmt != d_bodies[fun].size(); ++stmt)
+            run(d_bodies[fun][stmt], frame, depth);
+
+        return variable(frame, function.ret);
+    }
+
+    throw string("unknown function");
+}
+
+void Evaluator::run(Stmt const &stmt, Frame &frame, size_t depth)
+{
+    step();
+    switch (stmt.kind)
+    {
+        case Stmt::EXPR:
+            eval(stmt.exprs[0], frame, depth);
+            break;
+
+        case Stmt::IF:
+            if (number(stmt.exprs[0], frame, depth))
+                run(stmt.body[0], frame, depth);
+            else if (stmt.body.size() == 2)
+                run(stmt.body[1], frame, depth);
+            break;
+
+        case Stmt::FOR:
+        {
+            // Mirror Parser::startFor/stopFor: run while var <= stop, then var += step
+            string const &var = stmt.exprs[0].text;
+            bool hasStep = stmt.exprs.size() == 4;
+            int start = number(stmt.exprs[1], frame, depth);
+            int inc = hasStep ? number(stmt.exprs[2], frame, depth) : 1;
+            int stop = number(stmt.exprs.back(), frame, depth);
+
+            frame[var] = Value{false, {start}};
+            while (variable(frame, var).cells[0] <= stop)
+            {
+                run(stmt.body[0], frame, depth);
+                Value &value = variable(frame, var);
+                if (value.array)
+                    throw string("array as loop variable");
+                value.cells[0] = check(value.cells[0] + inc);
+            }
+            break;
+        }
+
+        case Stmt::BLOCK:
+            for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+                run(stmt.body[idx], frame, depth);
+            break;
+
+        default:
+            throw string("I/O");
+    }
+}
+
+Evaluator::Value Evaluator::eval(Expr const &expr, Frame &frame, size_t depth)
+{
+    step();
+
+    Value value;
+    if (literal(expr, value))
+        return value;
+
+    switch (expr.kind)
+    {
+        case Expr::VAR:
+            return variable(frame, expr.text);
+
+        case Expr::LIST:
+        {
+            value.array = true;
+            for (size_t idx = 0; idx != expr.args.size(); ++idx)
+                value.cells.push_back(number(expr.args[idx], frame, depth));
+            if (value.cells.size() > MAX_ARRAY_SIZE)
+                throw string("array too big");
+            return value;
+        }
+
+        case Expr::CALL:
+        {
+            vector<Value> args;
+            for (size_t idx = 0; idx != expr.args.size(); ++idx)
+                args.push_back(eval(expr.args[idx], frame, depth));
+            return call(expr.text, args, depth + 1);
+        }
+
+        case Expr::ELEMENT:
+        {
+            int index = number(expr.args[0], frame, depth);
+            Value const &array = variable(frame, expr.text);
+            if (!array.array || index >= (int)array.cells.size())
+                throw string("bad index");
+            return Value{false, {array.cells[index]}};
+        }
+
+        case Expr::NOT:
+            return Value{false, {!number(expr.args[0], frame, depth)}};
+
+        case Expr::BINARY:
+        {
+            Expr folded{Expr::BINARY, expr.text, {}};
+            folded.args.push_back(Expr{Expr::NUMBER, to_string(number(expr.args[0], frame, depth)), {}});
+            folded.args.push_back(Expr{Expr::NUMBER, to_string(number(expr.args[1], frame, depth)), {}});
+
+            int result;
+            if (!constant(folded, result))
+                throw string("undefined");
+            return Value{false, {check(result)}};
+        }
+
+        case Expr::ASSIGN:
+        {
+            Expr const &lhs = expr.args[0];
+            Value rhs = eval(expr.args[1], frame, depth);
+            string op = expr.text.substr(0, expr.text.length() - 1);     // "+=" -> "+"
+
+            if (lhs.kind == Expr::VAR && op.empty())
+                return frame[lhs.text] = rhs;
+
+            if (rhs.array)
+                throw string("array operand");
+
+            int *target;
+            if (lhs.kind == Expr::VAR)
+            {
+                Value &var = variable(frame, lhs.text);
+                if (var.array)
+                    throw string("array operand");
+                target = &var.cells[0];
+            }
+            else
+            {
+                int index = number(lhs.args[0], frame, depth);
+                Value &array = variable(frame, lhs.text);
+                if (!array.array || index >= (int)array.cells.size())
+                    throw string("bad index");
+                target = &array.cells[index];
+            }
+
+            if (op.empty())
+                *target = rhs.cells[0];
+            else
+            {
+                Expr folded{Expr::BINARY, op, {Expr{Expr::NUMBER, to_string(*target), {}},
+                                               Expr{Expr::NUMBER, to_string(rhs.cells[0]), {}}}};
+                int result;
+                if (!constant(folded, result))
+                    throw string("undefined");
+                *target = check(result);
+            }
+
+            return Value{false, {*target}};
+        }
+
+        default:
+            throw string("unsupported");
+    }
+}
+
+int Evaluator::number(Expr const &expr, Frame &frame, size_t depth)
+{
+    Value value = eval(expr, frame, depth);
+    if (value.array)
+        throw string("array operand");
+
+    return value.cells[0];
+}
+
+Evaluator::Value &Evaluator::variable(Frame &frame, string const &name)
+{
+    auto it = frame.find(name);
+    if (it == frame.end())
+        throw string("uninitialized");      // would read whatever the cell holds
+
+    return it->second;
+}
+
+void Evaluator::step()
+{
+    if (d_steps-- == 0)
+        throw string("too expensive");
+}
+
+bool Evaluator::literal(Expr const &expr, Value &value)
+{
+    int number;
+    if (constant(expr, number))
+    {
+        value = Value{false, {check(number)}};
+        return true;
+    }
+
+    if (expr.kind == Expr::STRING)
+    {
+        value = Value{true, stringValue(expr.text)};
+        return true;
+    }
+
+    if (expr.kind == Expr::NEW_ARRAY)
+    {
+        int size = stoi(expr.args[0].text);
+        int init = 0;
+        if (expr.args.size() == 2 && !constant(expr.args[1], init))
+            return false;
+        if (size > (int)MAX_ARRAY_SIZE)
+            return false;
+
+        value = Value{true, vector<int>(size, init)};
+        return true;
+    }
+
+    if (expr.kind == Expr::LIST)
+    {
+        value = Value{true, {}};
+        for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        {
+            if (!constant(expr.args[idx], number))
+                return false;
+            value.cells.push_back(check(number));
+        }
+        return value.cells.size() <= MAX_ARRAY_SIZE;
+    }
+
+    return false;
+}
+
+Expr Evaluator::expression(Value const &value)
+{
+    if (!value.array)
+        return Expr{Expr::NUMBER, to_string(value.cells[0]), {}};
+
+    Expr list{Expr::LIST, "", {}};
+    for (size_t idx = 0; idx != value.cells.size(); ++idx)
+        list.args.push_back(Expr{Expr::NUMBER, to_string(value.cells[idx]), {}});
+
+    return list;
+}
+
+int Evaluator::check(int value)
+{
+    if (value > 255)
+        throw string("overflow");       // depends on the cell size of the interpreter
+
+    return value;
+}
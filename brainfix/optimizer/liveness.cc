@@ -0,0 +1,78 @@
+#include "optimizer.ih"
+
+Liveness::Liveness(string const &body)
+:
+    d_count(0)
+{
+    vector<Stmt> stmts;
+    try
+    {
+        stmts = Source(body).parse();
+    }
+    catch (string const &)
+    {
+        return;             // no schedule: nothing is freed early
+    }
+
+    for (size_t idx = 0; idx != stmts.size(); ++idx)
+        visit(stmts[idx], 0);
+
+    for (auto it = d_lastUse.begin(); it != d_lastUse.end(); ++it)
+        d_dead[it->second].push_back(it->first);
+}
+
+vector<string> const &Liveness::dead(size_t stmt) const
+{
+    static vector<string> const none;
+
+    auto it = d_dead.find(stmt);
+    return it == d_dead.end() ? none : it->second;
+}
+
+void Liveness::visit(Stmt const &stmt, size_t loop)
+{
+    if (stmt.kind == Stmt::BLOCK)
+    {
+        for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+            visit(stmt.body[idx], loop);
+        return;
+    }
+
+    // This statement is reduced after all statements nested in it
+    size_t self = d_count + numbered(stmt);
+
+    // Inside a loop, an earlier statement may run after a later one: keep
+    // everything used in the loop alive until the outermost loop is done.
+    if (stmt.kind == Stmt::FOR && loop == 0)
+        loop = self;
+
+    for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+        use(stmt.exprs[idx], loop ? loop : self);
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        visit(stmt.body[idx], loop);
+
+    ++d_count;
+}
+
+void Liveness::use(Expr const &expr, size_t stmt)
+{
+    if (expr.kind == Expr::VAR || expr.kind == Expr::ELEMENT)
+    {
+        size_t &last = d_lastUse[expr.text];
+        if (stmt > last)
+            last = stmt;
+    }
+
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        use(expr.args[idx], stmt);
+}
+
+size_t Liveness::numbered(Stmt const &stmt)
+{
+    size_t count = stmt.kind == Stmt::BLOCK ? 0 : 1;
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        count += numbered(stmt.body[idx]);
+
+    return count;
+}
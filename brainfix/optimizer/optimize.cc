@@ -0,0 +1,171 @@
+#include "optimizer.ih"
+#include <memory>
+
+namespace
+{
+    typedef vector<Preprocessor::Function> Functions;
+
+    // Functions that can not be reached from main will never be compiled
+    void removeUnreachable(Functions &functions, vector<vector<Stmt>> &bodies)
+    {
+        set<string> reachable;
+        vector<string> todo(1, "main");
+        while (!todo.empty())
+        {
+            string name = todo.back();
+            todo.pop_back();
+            if (!reachable.insert(name).second)
+                continue;
+
+            for (size_t idx = 0; idx != functions.size(); ++idx)
+            {
+                if (functions[idx].name != name)
+                    continue;
+
+                set<string> callees;
+                for (size_t stmt = 0; stmt != bodies[idx].size(); ++stmt)
+                    calls(bodies[idx][stmt], callees);
+                todo.insert(todo.end(), callees.begin(), callees.end());
+            }
+        }
+
+        for (size_t idx = functions.size(); idx--; )
+        {
+            if (!reachable.count(functions[idx].name))
+            {
+                functions.erase(functions.begin() + idx);
+                bodies.erase(bodies.begin() + idx);
+            }
+        }
+    }
+
+    // What optimizing a function depends on: the options and, in program
+    // order, the function itself and every function it may evaluate, with
+    // their bodies before optimizing and whether they are optimized first
+    string cacheKey(Functions const &functions, vector<vector<Stmt>> const &bodies,
+                    size_t function, Options const &options)
+    {
+        set<string> closure;
+        vector<string> todo(1, functions[function].name);
+        while (!todo.empty())
+        {
+            string name = todo.back();
+            todo.pop_back();
+            if (!closure.insert(name).second)
+                continue;
+
+            for (size_t idx = 0; idx != functions.size(); ++idx)
+            {
+                if (functions[idx].name != name)
+                    continue;
+
+                set<string> callees;
+                for (size_t stmt = 0; stmt != bodies[idx].size(); ++stmt)
+                    calls(bodies[idx][stmt], callees);
+                todo.insert(todo.end(), callees.begin(), callees.end());
+            }
+        }
+
+        ostringstream key;
+        key << "unroll " << options.unrollBudget << " dce " << options.deadCode
+            << " eval " << options.evaluate << '\n';
+        for (size_t idx = 0; idx != functions.size(); ++idx)
+        {
+            Preprocessor::Function const &callee = functions[idx];
+            if (!closure.count(callee.name))
+                continue;
+
+            key << (idx < function ? "before " : idx == function ? "this " : "after ")
+                << callee.ret << ' ' << callee.name;
+            for (size_t arg = 0; arg != callee.args.size(); ++arg)
+                key << ' ' << callee.args[arg];
+            key << ' ' << callee.body.size() << '\n' << callee.body;
+        }
+        return key.str();
+    }
+}
+
+void Optimizer::calls(Stmt const &stmt, set<string> &callees)
+{
+    for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+        calls(stmt.exprs[idx], callees);
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        calls(stmt.body[idx], callees);
+}
+
+void Optimizer::calls(Expr const &expr, set<string> &callees)
+{
+    if (expr.kind == Expr::CALL)
+        callees.insert(expr.text);
+
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        calls(expr.args[idx], callees);
+}
+
+void Optimizer::optimize(Preprocessor::Parser &preprocessor, Options const &options)
+{
+    Functions &functions = preprocessor.functions();
+
+    vector<vector<Stmt>> bodies(functions.size());
+    for (size_t idx = 0; idx != functions.size(); ++idx)
+    {
+        try
+        {
+            bodies[idx] = Source(functions[idx].body).parse();
+        }
+        catch (string const &)
+        {
+            return;         // leave it to the compiler to report the error
+        }
+    }
+
+    // Keys of the bodies as they are now, see cacheKey()
+    vector<string> keys;
+    unique_ptr<Cache> cache;
+    if (!options.cache.empty())
+    {
+        cache.reset(new Cache(options.cache));
+        for (size_t idx = 0; idx != functions.size(); ++idx)
+            keys.push_back(cacheKey(functions, bodies, idx, options));
+    }
+
+    Unroller unroller(options.unrollBudget);
+    Evaluator evaluator(functions, bodies);
+    for (size_t idx = 0; idx != functions.size(); ++idx)
+    {
+        string body;
+        if (cache && cache->find(keys[idx], body))
+        {
+            try
+            {
+                bodies[idx] = Source(body).parse();
+                functions[idx].body = body;
+                continue;
+            }
+            catch (string const &)
+            {}              // not written by us, optimize it again
+        }
+
+        bool changed = false;
+        if (options.unrollBudget != 0)
+            changed |= unroller.unroll(bodies[idx]);
+
+        if (options.evaluate)
+            changed |= evaluator.fold(bodies[idx]);
+
+        if (options.deadCode)
+            changed |= DeadCode(functions[idx].ret).eliminate(bodies[idx]);
+
+        changed |= splitConditions(bodies[idx]);
+
+        if (changed)
+            functions[idx].body = Source::write(bodies[idx]);
+        if (cache)
+            cache->store(keys[idx], functions[idx].body);
+    }
+
+    // After evaluation, as some functions may not be called anymore
+    if (options.deadCode)
+        removeUnreachable(functions, bodies);
+}
@@ -0,0 +1,290 @@
+#ifndef Optimizer_h_included
+#define Optimizer_h_included
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <iosfwd>
+#include "../preprocessor/ppparser.h"
+
+namespace Optimizer
+{
+
+struct Token
+{
+    enum Type
+    {
+        END,
+        IDENT,
+        FUNNAME,
+        NUMBER,
+        CHAR,
+        STRING,
+        KEYWORD,
+        OPERATOR
+    };
+
+    Type            type;
+    std::string     text;       // exactly as it appears in the source
+    size_t          line;       // counting from 1
+};
+
+struct Expr
+{
+    enum Kind
+    {
+        VAR,            // text: identifier
+        NUMBER,         // text: literal
+        CHAR,           // text: literal, including quotes
+        STRING,         // text: literal, including quotes
+        LIST,           // args: elements
+        NEW_ARRAY,      // args: size [, value]
+        CALL,           // text: function name, args: arguments
+        ELEMENT,        // text: identifier, args: index
+        ASSIGN,         // text: operator, args: lvalue, rvalue
+        BINARY,         // text: operator, args: lhs, rhs
+        NOT             // args: operand
+    };
+
+    Kind                kind;
+    std::string         text;
+    std::vector<Expr>   args;
+};
+
+struct Stmt
+{
+    enum Kind
+    {
+        EXPR,           // exprs: expression
+        PRINTC,         // exprs: expression, text: "print" or "printc"
+        PRINTD,         // exprs: expression
+        PRINTS,         // exprs: expression
+        SCAN,           // exprs: lvalue
+        IF,             // exprs: condition, body: then [, else]
+        FOR,            // exprs: variable, start, [step,] stop, body: statement
+        BLOCK           // body: statements
+    };
+
+    Kind                kind;
+    std::string         text;
+    std::vector<Expr>   exprs;
+    std::vector<Stmt>   body;
+    size_t              line;       // of its first token, 0 if unknown
+};
+
+class Source
+{
+    std::vector<Token>  d_tokens;
+    size_t              d_pos;
+
+    public:
+        explicit Source(std::string const &text);
+
+        std::vector<Stmt> parse();      // throws std::string on syntax errors
+        static std::string write(std::vector<Stmt> const &body);
+        static std::vector<Token> tokenize(std::string const &text);
+
+    private:
+        Token const &peek(size_t ahead = 0) const;
+        Token const &next();
+        bool accept(std::string const &text);
+        void expect(std::string const &text);
+
+        Stmt statement();
+        Expr expression(int minPrec = 1);
+        Expr unary();
+        Expr primary();
+        std::vector<Expr> list(std::string const &close);
+
+        static void write(std::ostringstream &out, Stmt const &stmt, size_t indent);
+        static void write(std::ostream &out, Expr const &expr);
+        static void align(std::ostringstream &out, size_t line);
+};
+
+struct Options
+{
+    size_t      unrollBudget;   // see Unroller, 0 disables unrolling
+    bool        deadCode;       // remove unused functions, stores and expressions
+    bool        evaluate;       // see Evaluator
+    size_t      shareBudget;    // see CallGraph, 0 only shares recursive functions
+    std::string cache;          // directory, see Cache, empty if not cached
+
+    Options()
+    :
+        unrollBudget(64),
+        deadCode(true),
+        evaluate(true),
+        shareBudget(0)
+    {}
+};
+
+    // Optimized function bodies on disk, by a hash of everything they were
+    // optimized from. The whole key is stored along, so a collision is a miss.
+class Cache
+{
+    std::string d_directory;
+
+    public:
+        explicit Cache(std::string const &directory);
+        bool find(std::string const &key, std::string &value) const;
+        void store(std::string const &key, std::string const &value) const;    // may fail silently
+        static unsigned long long hash(std::string const &text);
+
+    private:
+        std::string path(std::string const &key) const;
+};
+
+class Unroller
+{
+    size_t d_budget;        // maximum number of nodes a single loop may expand to
+
+    public:
+        explicit Unroller(size_t budget);
+        bool unroll(std::vector<Stmt> &body);   // true if any loop was unrolled
+
+    private:
+        bool unroll(Stmt &stmt);
+        bool tripCount(Stmt const &loop, std::vector<int> &values) const;
+
+        static bool assigns(Stmt const &stmt, std::string const &var);
+        static bool assigns(Expr const &expr, std::string const &var);
+        static void substitute(Stmt &stmt, std::string const &var, int value);
+        static void substitute(Expr &expr, std::string const &var, int value);
+        static size_t size(Stmt const &stmt);
+        static size_t size(Expr const &expr);
+};
+
+    // Removes side-effect free expression statements, stores to variables
+    // that are never read and branches that can never be taken.
+class DeadCode
+{
+    std::string     d_ret;      // the return variable is read by the caller
+
+    public:
+        explicit DeadCode(std::string const &ret);
+        bool eliminate(std::vector<Stmt> &body);    // true if anything was removed
+        static bool pure(Expr const &expr);         // no assignments or calls
+
+    private:
+        bool sweep(std::vector<Stmt> &body, std::set<std::string> const &read) const;
+        bool sweep(Stmt &stmt, std::set<std::string> const &read) const;
+        bool strip(Expr &expr, std::set<std::string> const &read) const;
+        bool dead(Expr const &lvalue, std::set<std::string> const &read) const;
+
+        static void reads(Stmt const &stmt, std::set<std::string> &read);
+        static void reads(Expr const &expr, std::set<std::string> &read);
+        static bool empty(Stmt const &stmt);
+};
+
+    // Determines after which statement each variable of a function body is
+    // used for the last time. Statements are numbered in the order in which
+    // the compiler's grammar reduces them (and calls collectGarbage()):
+    // nested statements before the if/for containing them, blocks not at all.
+class Liveness
+{
+    typedef std::map<size_t, std::vector<std::string>> Schedule;
+
+    Schedule                        d_dead;         // statement -> variables dead after it
+    std::map<std::string, size_t>   d_lastUse;
+    size_t                          d_count;
+
+    public:
+        explicit Liveness(std::string const &body);
+        std::vector<std::string> const &dead(size_t stmt) const;
+
+    private:
+        void visit(Stmt const &stmt, size_t loop);
+        void use(Expr const &expr, size_t stmt);
+        static size_t numbered(Stmt const &stmt);
+};
+
+    // Runs functions at compile-time: a call with literal arguments to a
+    // function that does no I/O is replaced by the literal it returns.
+class Evaluator
+{
+    struct Value
+    {
+        bool                array;
+        std::vector<int>    cells;      // a single one if not an array
+    };
+    typedef std::map<std::string, Value> Frame;
+
+    std::vector<Preprocessor::Function> const   &d_functions;
+    std::vector<std::vector<Stmt>> const        &d_bodies;
+    size_t                                      d_steps;    // left for the current call
+
+    public:
+        Evaluator(std::vector<Preprocessor::Function> const &functions,
+                  std::vector<std::vector<Stmt>> const &bodies);
+        bool fold(std::vector<Stmt> &body);     // true if any call was replaced
+
+    private:
+        bool fold(Stmt &stmt);
+        bool fold(Expr &expr);
+
+            // These throw std::string when something can't be evaluated
+        Value call(std::string const &name, std::vector<Value> const &args, size_t depth);
+        void run(Stmt const &stmt, Frame &frame, size_t depth);
+        Value eval(Expr const &expr, Frame &frame, size_t depth);
+        int number(Expr const &expr, Frame &frame, size_t depth);
+        Value &variable(Frame &frame, std::string const &name);
+        void step();
+
+        static bool literal(Expr const &expr, Value &value);
+        static Expr expression(Value const &value);
+        static int check(int value);
+};
+
+    // Decides which functions are emitted once (shared) instead of being
+    // inlined at every call: recursive functions always, others when the
+    // tokens saved by not inlining them exceed the share budget.
+class CallGraph
+{
+    std::map<std::string, std::set<std::string>>   d_callees;
+    std::set<std::string>                           d_shared;
+    std::set<std::string>                           d_splits;   // calling these ends a dispatch block
+
+    public:
+        CallGraph() = default;
+        CallGraph(std::vector<Preprocessor::Function> const &functions, size_t shareBudget);
+
+        std::set<std::string> const &shared() const;
+        bool reaches(std::string const &from, std::string const &to) const;
+
+            // Longest chain of nested calls to shared functions starting at
+            // main. False if there is no limit (recursion).
+        bool depth(size_t &calls) const;
+
+            // For every if/for in the body (in source order): whether it
+            // contains a call that ends the current dispatch block.
+        std::vector<bool> blockMode(std::string const &body) const;
+
+    private:
+        size_t depth(std::string const &name, std::map<std::string, size_t> &memo) const;
+        bool splits(Stmt const &stmt) const;
+        bool splits(Expr const &expr) const;
+        void blockMode(Stmt const &stmt, std::vector<bool> &modes) const;
+};
+
+    // Evaluates expressions consisting of literals only. Returns false if
+    // the value cannot be determined at compile-time.
+bool constant(Expr const &expr, int &value);
+int  charValue(std::string const &literal);
+
+    // Rewrites if (a && b) S into if a if b S when b has no side effects,
+    // so b is only evaluated if a holds, and if !a S else T into if a T else S.
+bool splitConditions(std::vector<Stmt> &body);     // true if anything changed
+
+    // For every if/for in the body (in source order): whether it is an if
+    // with an else. Empty if the body can not be parsed.
+std::vector<bool> elseBranches(std::string const &body);
+
+void calls(Stmt const &stmt, std::set<std::string> &callees);
+void calls(Expr const &expr, std::set<std::string> &callees);
+
+void optimize(Preprocessor::Parser &preprocessor, Options const &options);
+
+}
+
+#endif
@@ -0,0 +1,523 @@
+#include "optimizer.ih"
+
+namespace
+{
+    char const *s_keywords[] =
+    {
+        "print", "printc", "printd", "prints", "scan", "array", "if", "else", "for"
+    };
+
+    char const *s_doubleOps[] =
+    {
+        "<=", ">=", "==", "!=", "+=", "-=", "/=", "*=", "%=", "&&", "||"
+    };
+
+    // Binding strength of the binary operators, mirroring the precedence
+    // declarations in compiler/grammar. Assignments (3) are handled in
+    // Source::primary(), since their left-hand side must be an lvalue.
+    int precedence(Token const &token)
+    {
+        if (token.type != Token::OPERATOR)
+            return 0;
+
+        string const &op = token.text;
+        if (op == "&&" || op == "||")
+            return 1;
+        if (op == "<" || op == ">" || op == "<=" || op == ">=" || op == "==" || op == "!=")
+            return 2;
+        if (op == "+" || op == "-")
+            return 4;
+        if (op == "*" || op == "/" || op == "%")
+            return 5;
+
+        return 0;
+    }
+
+    bool isAssignment(Token const &token)
+    {
+        return token.type == Token::OPERATOR &&
+               (token.text == "=" || token.text == "+=" || token.text == "-=" ||
+                token.text == "*=" || token.text == "/=" || token.text == "%=");
+    }
+}
+
+Source::Source(string const &text)
+:
+    d_tokens(tokenize(text)),
+    d_pos(0)
+{}
+
+vector<Token> Source::tokenize(string const &text)
+{
+    vector<Token> tokens;
+    size_t idx = 0;
+    size_t const len = text.length();
+    size_t line = 1;
+    size_t counted = 0;         // newlines before this position are in line
+
+    while (idx != len)
+    {
+        char ch = text[idx];
+
+        if (isspace(ch))
+        {
+            ++idx;
+            continue;
+        }
+
+        if (text.compare(idx, 2, "//") == 0)
+        {
+            idx = text.find('\n', idx);
+            if (idx == string::npos)
+                idx = len;
+            continue;
+        }
+
+        if (text.compare(idx, 2, "/*") == 0)
+        {
+            idx = text.find("*/", idx + 2);
+            idx = (idx == string::npos) ? len : idx + 2;
+            continue;
+        }
+
+        Token token;
+        size_t begin = idx;
+        line += count(text.begin() + counted, text.begin() + begin, '\n');
+        counted = begin;
+        token.line = line;
+
+        if (isalpha(ch))
+        {
+            while (idx != len && isalnum(text[idx]))
+                ++idx;
+
+            token.text = text.substr(begin, idx - begin);
+            token.type = Token::IDENT;
+
+            if (idx != len && text[idx] == '(')     // the scanner's {ident}/'('
+                token.type = Token::FUNNAME;
+            else
+            {
+                for (char const *keyword: s_keywords)
+                    if (token.text == keyword)
+                        token.type = Token::KEYWORD;
+            }
+        }
+        else if (isdigit(ch))
+        {
+            while (idx != len && isdigit(text[idx]))
+                ++idx;
+
+            token.type = Token::NUMBER;
+            token.text = text.substr(begin, idx - begin);
+        }
+        else if (ch == '\'')
+        {
+            idx += (idx + 1 != len && text[idx + 1] == '\\') ? 4 : 3;
+            if (idx > len)
+                throw string("Error: unterminated character literal.");
+
+            token.type = Token::CHAR;
+            token.text = text.substr(begin, idx - begin);
+        }
+        else if (ch == '"')
+        {
+            for (++idx; idx != len && text[idx] != '"'; ++idx)
+                if (text[idx] == '\\' && idx + 1 != len)
+                    ++idx;
+
+            if (idx == len)
+                throw string("Error: unterminated string literal.");
+
+            ++idx;
+            token.type = Token::STRING;
+            token.text = text.substr(begin, idx - begin);
+        }
+        else
+        {
+            token.type = Token::OPERATOR;
+            token.text = string(1, ch);
+            for (char const *op: s_doubleOps)
+                if (text.compare(idx, 2, op) == 0)
+                    token.text = op;
+
+            idx += token.text.length();
+        }
+
+        tokens.push_back(token);
+    }
+
+    Token end;
+    end.type = Token::END;
+    end.line = line + count(text.begin() + counted, text.end(), '\n');
+    tokens.push_back(end);
+
+    return tokens;
+}
+
+Token const &Source::peek(size_t ahead) const
+{
+    size_t idx = d_pos + ahead;
+    return d_tokens[idx < d_tokens.size() ? idx : d_tokens.size() - 1];
+}
+
+Token const &Source::next()
+{
+    Token const &token = peek();
+    if (d_pos + 1 < d_tokens.size())
+        ++d_pos;
+    return token;
+}
+
+bool Source::accept(string const &text)
+{
+    Token const &token = peek();
+    if (token.type == Token::END || token.type == Token::STRING ||
+        token.type == Token::CHAR || token.text != text)
+        return false;
+
+    next();
+    return true;
+}
+
+void Source::expect(string const &text)
+{
+    if (!accept(text))
+        throw string("Error: expected '") + text + "' but found '" + peek().text + "'.";
+}
+
+vector<Stmt> Source::parse()
+{
+    d_pos = 0;
+    vector<Stmt> body;
+    while (peek().type != Token::END)
+        body.push_back(statement());
+
+    return body;
+}
+
+Stmt Source::statement()
+{
+    Stmt stmt;
+    Token const &token = peek();
+    stmt.line = token.line;
+
+    if (token.type == Token::OPERATOR && token.text == "{")
+    {
+        next();
+        stmt.kind = Stmt::BLOCK;
+        while (!accept("}"))
+        {
+            if (peek().type == Token::END)
+                throw string("Error: expected '}'.");
+            stmt.body.push_back(statement());
+        }
+        return stmt;
+    }
+
+    if (token.type != Token::KEYWORD)
+    {
+        stmt.kind = Stmt::EXPR;
+        stmt.exprs.push_back(expression());
+        expect(";");
+        return stmt;
+    }
+
+    string keyword = next().text;
+    if (keyword == "print" || keyword == "printc" || keyword == "printd" || keyword == "prints")
+    {
+        stmt.kind = keyword == "printd" ? Stmt::PRINTD :
+                    keyword == "prints" ? Stmt::PRINTS : Stmt::PRINTC;
+        stmt.text = keyword;
+        stmt.exprs.push_back(expression());
+        expect(";");
+    }
+    else if (keyword == "scan")
+    {
+        if (peek().type != Token::IDENT)
+            throw string("Error: scan expects a variable.");
+
+        stmt.kind = Stmt::SCAN;
+        stmt.exprs.push_back(Expr{Expr::VAR, next().text, {}});
+        expect(";");
+    }
+    else if (keyword == "if")
+    {
+        stmt.kind = Stmt::IF;
+        stmt.exprs.push_back(expression());
+        stmt.body.push_back(statement());
+        if (accept("else"))
+            stmt.body.push_back(statement());
+    }
+    else if (keyword == "for")
+    {
+        if (peek().type != Token::IDENT)
+            throw string("Error: for expects a loop variable.");
+
+        stmt.kind = Stmt::FOR;
+        stmt.exprs.push_back(Expr{Expr::VAR, next().text, {}});
+        expect("=");
+        stmt.exprs.push_back(expression());
+        expect(":");
+        stmt.exprs.push_back(expression());
+        if (accept(":"))
+            stmt.exprs.push_back(expression());
+        stmt.body.push_back(statement());
+    }
+    else
+    {
+        // 'array' starts an expression statement
+        --d_pos;
+        stmt.kind = Stmt::EXPR;
+        stmt.exprs.push_back(expression());
+        expect(";");
+    }
+
+    return stmt;
+}
+
+Expr Source::expression(int minPrec)
+{
+    Expr lhs = unary();
+
+    while (true)
+    {
+        int prec = precedence(peek());
+        if (prec == 0 || prec < minPrec)
+            return lhs;
+
+        string op = next().text;
+        Expr rhs = expression(prec + 1);        // all binary operators are left-associative
+        lhs = Expr{Expr::BINARY, op, {lhs, rhs}};
+    }
+}
+
+Expr Source::unary()
+{
+    if (accept("!"))
+        return Expr{Expr::NOT, "!", {expression(6)}};
+
+    return primary();
+}
+
+Expr Source::primary()
+{
+    Token token = next();
+
+    switch (token.type)
+    {
+        case Token::NUMBER:
+            return Expr{Expr::NUMBER, token.text, {}};
+        case Token::CHAR:
+            return Expr{Expr::CHAR, token.text, {}};
+        case Token::STRING:
+            return Expr{Expr::STRING, token.text, {}};
+        case Token::FUNNAME:
+        {
+            expect("(");
+            return Expr{Expr::CALL, token.text, list(")")};
+        }
+        case Token::KEYWORD:
+        {
+            if (token.text != "array")
+                break;
+
+            Expr expr{Expr::NEW_ARRAY, token.text, {}};
+            if (peek().type != Token::NUMBER)
+                throw string("Error: array expects a constant size.");
+
+            expr.args.push_back(primary());
+            if (peek().type == Token::NUMBER || peek().type == Token::CHAR)
+                expr.args.push_back(primary());
+
+            return expr;
+        }
+        case Token::IDENT:
+        {
+            Expr lvalue{Expr::VAR, token.text, {}};
+            if (accept("["))
+            {
+                lvalue.kind = Expr::ELEMENT;
+                lvalue.args.push_back(expression());
+                expect("]");
+            }
+
+            if (!isAssignment(peek()))
+                return lvalue;
+
+            string op = next().text;
+            return Expr{Expr::ASSIGN, op, {lvalue, expression(4)}};
+        }
+        case Token::OPERATOR:
+        {
+            if (token.text == "(")
+            {
+                Expr expr = expression();
+                expect(")");
+                return expr;
+            }
+
+            if (token.text == "[")
+                return Expr{Expr::LIST, "[]", list("]")};
+
+            break;
+        }
+        default:
+            break;
+    }
+
+    throw string("Error: unexpected '") + token.text + "' in expression.";
+}
+
+vector<Expr> Source::list(string const &close)
+{
+    vector<Expr> elements;
+    if (accept(close))
+        return elements;
+
+    do
+        elements.push_back(expression());
+    while (accept(","));
+
+    expect(close);
+    return elements;
+}
+
+string Source::write(vector<Stmt> const &body)
+{
+    ostringstream out;
+    for (size_t idx = 0; idx != body.size(); ++idx)
+        write(out, body[idx], 1);
+
+    return out.str();
+}
+
+    // Statements are written on their original lines where possible, so
+    // the compiler's line numbers still refer to the source
+void Source::write(ostringstream &out, Stmt const &stmt, size_t indent)
+{
+    align(out, stmt.line);
+    string tab(4 * indent, ' ');
+    out << tab;
+
+    switch (stmt.kind)
+    {
+        case Stmt::EXPR:
+            write(out, stmt.exprs[0]);
+            out << ";\n";
+            break;
+        case Stmt::PRINTC:
+        case Stmt::PRINTD:
+        case Stmt::PRINTS:
+            out << (stmt.kind == Stmt::PRINTD ? "printd " :
+                    stmt.kind == Stmt::PRINTS ? "prints " : "printc ");
+            write(out, stmt.exprs[0]);
+            out << ";\n";
+            break;
+        case Stmt::SCAN:
+            out << "scan " << stmt.exprs[0].text << ";\n";
+            break;
+        case Stmt::IF:
+        {
+            out << "if ";
+            write(out, stmt.exprs[0]);
+            out << '\n';
+
+            // Always brace the then-part, so a nested if can not steal our else
+            Stmt then{Stmt::BLOCK, "", {}, {stmt.body[0]}, stmt.body[0].line};
+            write(out, stmt.body[0].kind == Stmt::BLOCK ? stmt.body[0] : then, indent);
+            if (stmt.body.size() == 2)
+            {
+                out << tab << "else\n";
+                write(out, stmt.body[1], indent + 1);
+            }
+            break;
+        }
+        case Stmt::FOR:
+        {
+            out << "for " << stmt.exprs[0].text << " = ";
+            for (size_t idx = 1; idx != stmt.exprs.size(); ++idx)
+            {
+                if (idx != 1)
+                    out << " : ";
+                write(out, stmt.exprs[idx]);
+            }
+            out << '\n';
+            write(out, stmt.body[0], indent + 1);
+            break;
+        }
+        case Stmt::BLOCK:
+        {
+            out << "{\n";
+            for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+                write(out, stmt.body[idx], indent + 1);
+            out << tab << "}\n";
+            break;
+        }
+    }
+}
+
+void Source::align(ostringstream &out, size_t line)
+{
+    string const &text = out.str();
+    size_t current = 1 + count(text.begin(), text.end(), '\n');
+    if (current < line)
+        out << string(line - current, '\n');
+}
+
+void Source::write(ostream &out, Expr const &expr)
+{
+    switch (expr.kind)
+    {
+        case Expr::VAR:
+        case Expr::NUMBER:
+        case Expr::CHAR:
+        case Expr::STRING:
+            out << expr.text;
+            break;
+        case Expr::LIST:
+        case Expr::CALL:
+        {
+            out << (expr.kind == Expr::CALL ? expr.text + "(" : "[");
+            for (size_t idx = 0; idx != expr.args.size(); ++idx)
+            {
+                if (idx != 0)
+                    out << ", ";
+                write(out, expr.args[idx]);
+            }
+            out << (expr.kind == Expr::CALL ? ")" : "]");
+            break;
+        }
+        case Expr::NEW_ARRAY:
+        {
+            out << "array";
+            for (size_t idx = 0; idx != expr.args.size(); ++idx)
+                out << ' ' << expr.args[idx].text;
+            break;
+        }
+        case Expr::ELEMENT:
+            out << expr.text << '[';
+            write(out, expr.args[0]);
+            out << ']';
+            break;
+        case Expr::ASSIGN:
+            out << '(';
+            write(out, expr.args[0]);
+            out << ' ' << expr.text << ' ';
+            write(out, expr.args[1]);
+            out << ')';
+            break;
+        case Expr::BINARY:
+            out << '(';
+            write(out, expr.args[0]);
+            out << ' ' << expr.text << ' ';
+            write(out, expr.args[1]);
+            out << ')';
+            break;
+        case Expr::NOT:
+            out << "!(";
+            write(out, expr.args[0]);
+            out << ')';
+            break;
+    }
+}
@@ -0,0 +1,144 @@
+#include "optimizer.ih"
+
+Unroller::Unroller(size_t budget)
+:
+    d_budget(budget)
+{}
+
+bool Unroller::unroll(vector<Stmt> &body)
+{
+    bool changed = false;
+    for (size_t idx = 0; idx != body.size(); ++idx)
+        changed |= unroll(body[idx]);
+
+    return changed;
+}
+
+bool Unroller::unroll(Stmt &stmt)
+{
+    // Inner loops first, so the size of the outer body is known
+    bool changed = unroll(stmt.body);
+
+    if (stmt.kind != Stmt::FOR)
+        return changed;
+
+    vector<int> values;
+    string const &var = stmt.exprs[0].text;
+    if (!tripCount(stmt, values) || assigns(stmt.body[0], var) ||
+        values.size() * size(stmt.body[0]) > d_budget)
+        return changed;
+
+    // Expand into straight-line code, the loop variable becoming a constant
+    Stmt block{Stmt::BLOCK, "", {}, {}, stmt.line};
+    for (size_t idx = 0; idx != values.size(); ++idx)
+    {
+        Stmt copy = stmt.body[0];
+        substitute(copy, var, values[idx]);
+        unroll(copy);                           // inner loops may have become constant
+        block.body.push_back(copy);
+    }
+
+    stmt = block;
+    return true;
+}
+
+bool Unroller::tripCount(Stmt const &loop, vector<int> &values) const
+{
+    int start;
+    int stop;
+    int step = 1;
+
+    bool hasStep = loop.exprs.size() == 4;
+    if (!constant(loop.exprs[1], start) ||
+        !constant(loop.exprs.back(), stop) ||
+        (hasStep && !constant(loop.exprs[2], step)))
+        return false;
+
+    // Mirror Parser::startFor/stopFor: run while var <= stop, then var += step
+    int var = start;
+    while (var <= stop)
+    {
+        if (step == 0 || values.size() > d_budget)
+            return false;
+
+        values.push_back(var);
+        var += step;
+    }
+
+    return var <= 255;      // never rely on the loop variable overflowing
+}
+
+bool Unroller::assigns(Stmt const &stmt, string const &var)
+{
+    if ((stmt.kind == Stmt::SCAN || stmt.kind == Stmt::FOR) && stmt.exprs[0].text == var)
+        return true;
+
+    for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+        if (assigns(stmt.exprs[idx], var))
+            return true;
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        if (assigns(stmt.body[idx], var))
+            return true;
+
+    return false;
+}
+
+bool Unroller::assigns(Expr const &expr, string const &var)
+{
+    // Indexing the loop variable can't be expressed with a constant either
+    if (expr.kind == Expr::ELEMENT && expr.text == var)
+        return true;
+
+    if (expr.kind == Expr::ASSIGN && expr.args[0].text == var)
+        return true;
+
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        if (assigns(expr.args[idx], var))
+            return true;
+
+    return false;
+}
+
+void Unroller::substitute(Stmt &stmt, string const &var, int value)
+{
+    for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+        substitute(stmt.exprs[idx], var, value);
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        substitute(stmt.body[idx], var, value);
+}
+
+void Unroller::substitute(Expr &expr, string const &var, int value)
+{
+    if (expr.kind == Expr::VAR && expr.text == var)
+    {
+        expr.kind = Expr::NUMBER;
+        expr.text = to_string(value);
+        return;
+    }
+
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        substitute(expr.args[idx], var, value);
+}
+
+size_t Unroller::size(Stmt const &stmt)
+{
+    size_t count = 1;
+    for (size_t idx = 0; idx != stmt.exprs.size(); ++idx)
+        count += size(stmt.exprs[idx]);
+
+    for (size_t idx = 0; idx != stmt.body.size(); ++idx)
+        count += size(stmt.body[idx]);
+
+    return count;
+}
+
+size_t Unroller::size(Expr const &expr)
+{
+    size_t count = 1;
+    for (size_t idx = 0; idx != expr.args.size(); ++idx)
+        count += size(expr.args[idx]);
+
+    return count;
+}
@@ -133,14 +133,14 @@ PI__ const s_productionInfo[] =
 // State info and SR__ transitions for each state.
 
 
-SR__ s_0[] =
+SR__ const s_0[] =
 {
     { { DEF_RED}, {  2} },           
     { {     265}, {  1} }, // program
     { {       0}, { -1} },           
 };
 
-SR__ s_1[] =
+SR__ const s_1[] =
 {
     { { REQ_TOKEN}, {            4} },            
     { {       266}, {            2} }, // function
@@ -149,13 +149,13 @@ SR__ s_1[] =
     { {         0}, {            0} },            
 };
 
-SR__ s_2[] =
+SR__ const s_2[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -2} }, 
 };
 
-SR__ s_3[] =
+SR__ const s_3[] =
 {
     { { REQ_TOKEN}, { 3} },           
     { {       257}, { 4} }, // FUNNAME
@@ -163,21 +163,21 @@ SR__ s_3[] =
     { {         0}, { 0} },           
 };
 
-SR__ s_4[] =
+SR__ const s_4[] =
 {
     { { REQ_TOKEN}, { 2} },       
     { {        40}, { 6} }, // '('
     { {         0}, { 0} },       
 };
 
-SR__ s_5[] =
+SR__ const s_5[] =
 {
     { { REQ_TOKEN}, { 2} },       
     { {        61}, { 7} }, // '='
     { {         0}, { 0} },       
 };
 
-SR__ s_6[] =
+SR__ const s_6[] =
 {
     { { REQ_DEF}, {  4} },            
     { {     267}, {  8} }, // opt_list
@@ -186,55 +186,55 @@ SR__ s_6[] =
     { {       0}, { -6} },            
 };
 
-SR__ s_7[] =
+SR__ const s_7[] =
 {
     { { REQ_TOKEN}, {  2} },           
     { {       257}, { 11} }, // FUNNAME
     { {         0}, {  0} },           
 };
 
-SR__ s_8[] =
+SR__ const s_8[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {        41}, { 12} }, // ')'
     { {         0}, {  0} },       
 };
 
-SR__ s_9[] =
+SR__ const s_9[] =
 {
     { { REQ_DEF}, {  2} },       
     { {      44}, { 13} }, // ','
     { {       0}, { -5} },       
 };
 
-SR__ s_10[] =
+SR__ const s_10[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -7} }, 
 };
 
-SR__ s_11[] =
+SR__ const s_11[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {        40}, { 14} }, // '('
     { {         0}, {  0} },       
 };
 
-SR__ s_12[] =
+SR__ const s_12[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {       123}, { 15} }, // '{'
     { {         0}, {  0} },       
 };
 
-SR__ s_13[] =
+SR__ const s_13[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {       258}, { 16} }, // VAR
     { {         0}, {  0} },       
 };
 
-SR__ s_14[] =
+SR__ const s_14[] =
 {
     { { REQ_DEF}, {  4} },            
     { {     267}, { 17} }, // opt_list
@@ -243,7 +243,7 @@ SR__ s_14[] =
     { {       0}, { -6} },            
 };
 
-SR__ s_15[] =
+SR__ const s_15[] =
 {
     { { REQ_DEF}, {   4} },            
     { {     269}, {  18} }, // opt_body
@@ -252,59 +252,59 @@ SR__ s_15[] =
     { {       0}, { -10} },            
 };
 
-SR__ s_16[] =
+SR__ const s_16[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -8} }, 
 };
 
-SR__ s_17[] =
+SR__ const s_17[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {        41}, { 21} }, // ')'
     { {         0}, {  0} },       
 };
 
-SR__ s_18[] =
+SR__ const s_18[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {       125}, { 22} }, // '}'
     { {         0}, {  0} },       
 };
 
-SR__ s_19[] =
+SR__ const s_19[] =
 {
     { { REQ_DEF}, {  2} },       
     { {     259}, { 23} }, // CHR
     { {       0}, { -9} },       
 };
 
-SR__ s_20[] =
+SR__ const s_20[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -11} }, 
 };
 
-SR__ s_21[] =
+SR__ const s_21[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {       123}, { 24} }, // '{'
     { {         0}, {  0} },       
 };
 
-SR__ s_22[] =
+SR__ const s_22[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -3} }, 
 };
 
-SR__ s_23[] =
+SR__ const s_23[] =
 {
     { { DEF_RED}, {   1} }, 
     { {       0}, { -12} }, 
 };
 
-SR__ s_24[] =
+SR__ const s_24[] =
 {
     { { REQ_DEF}, {   4} },            
     { {     269}, {  25} }, // opt_body
@@ -313,14 +313,14 @@ SR__ s_24[] =
     { {       0}, { -10} },            
 };
 
-SR__ s_25[] =
+SR__ const s_25[] =
 {
     { { REQ_TOKEN}, {  2} },       
     { {       125}, { 26} }, // '}'
     { {         0}, {  0} },       
 };
 
-SR__ s_26[] =
+SR__ const s_26[] =
 {
     { { DEF_RED}, {  1} }, 
     { {       0}, { -4} }, 
@@ -328,7 +328,7 @@ SR__ s_26[] =
 
 
 // State array:
-SR__ *s_state[] =
+SR__ const *s_state[] =
 {
   s_0,  s_1,  s_2,  s_3,  s_4,  s_5,  s_6,  s_7,  s_8,  s_9,
   s_10,  s_11,  s_12,  s_13,  s_14,  s_15,  s_16,  s_17,  s_18,  s_19,
@@ -526,15 +526,13 @@ void Parser::nextToken()
 int Parser::lookup(bool recovery)
 {
     // $insert threading
-    SR__ *sr = s_state[d_state__];        // get the appropriate state-table
+    SR__ const *sr = s_state[d_state__];  // get the appropriate state-table
     int lastIdx = sr->d_lastIdx;        // sentinel-index in the SR__ array
 
-    SR__ *lastElementPtr = sr + lastIdx;
-    SR__ *elementPtr = sr + 1;            // start the search at s_xx[1]
+    SR__ const *lastElementPtr = sr + lastIdx;
+    SR__ const *elementPtr = sr + 1;      // start the search at s_xx[1]
 
-    lastElementPtr->d_token = d_token__;// set search-token
-
-    while (elementPtr->d_token != d_token__)
+    while (elementPtr != lastElementPtr && elementPtr->d_token != d_token__)   // patched, see grammar
         ++elementPtr;
 
     if (elementPtr == lastElementPtr)   // reached the last element
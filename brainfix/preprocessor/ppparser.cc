@@ -1,4 +1,5 @@
 #include "ppparser.ih"
+#include <algorithm>
 
 void Parser::addFunction(string const &retArg, 
                          string const &funName, 
@@ -10,6 +11,10 @@ void Parser::addFunction(string const &retArg,
     function.name = funName;
     function.args = args;
     function.body = body;
+    function.file = d_fileName;
+    
+    // The scanner has just seen the closing brace
+    function.line = d_scanner.lineNr() - count(body.begin(), body.end(), '\n');
     
     d_functions.push_back(function);
 }
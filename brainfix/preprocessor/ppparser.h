@@ -18,6 +18,8 @@ struct Function
     std::string                 name;
     std::vector<std::string>    args;
     std::string                 body;
+    std::string                 file;
+    size_t                      line;   // of the body's first character
 };
     
 #undef Parser
@@ -25,10 +27,12 @@ class Parser: public ParserBase
 {
     Scanner                     d_scanner;
     std::vector<Function>       d_functions;
+    std::string                 d_fileName;
     
     public:
         Function const &function(std::string const &funName) const;
-        int parse(std::istream &in);
+        std::vector<Function> &functions();
+        int parse(std::istream &in, std::string const &fileName = "");
 
     private:
         int parse();
@@ -50,8 +54,14 @@ class Parser: public ParserBase
                          std::string const &body);
 };
 
-inline int Parser::parse(std::istream &in)
+inline std::vector<Function> &Parser::functions()
 {
+    return d_functions;
+}
+
+inline int Parser::parse(std::istream &in, std::string const &fileName)
+{
+    d_fileName = fileName;
     d_scanner.switchStreams(in);
     return parse();
 }
@@ -0,0 +1,70 @@
+#include "server.ih"
+
+string Server::client(string const &path, Batch::Settings const &settings,
+                    vector<string> const &inputs, string const &output)
+{
+    // The server may run in another directory
+    char cwd[4096];
+    auto absolute = [&](string const &name)
+    {
+        return name.empty() || name[0] == '/' || getcwd(cwd, sizeof(cwd)) == 0 ? 
+                    name 
+                : 
+                    string(cwd) + '/' + name;
+    };
+
+    vector<string> paths;
+    for (string const &input: inputs)
+        paths.push_back(absolute(input));
+    Batch::Settings remote(settings);
+    remote.options.cache = absolute(settings.options.cache);
+
+    ostringstream request;
+    writeRequest(request, remote, paths);
+    string text = request.str();
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+        throw "Can't connect to " + path + ".";
+    strcpy(address.sun_path, path.c_str());
+
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection == -1 ||
+        connect(connection, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        if (connection != -1)
+            close(connection);
+        throw "Can't connect to " + path + ": " + strerror(errno) + ".";
+    }
+
+    for (size_t done = 0; done != text.size(); )
+    {
+        ssize_t count = write(connection, text.data() + done, text.size() - done);
+        if (count <= 0)
+            break;
+        done += count;
+    }
+
+    string reply;
+    char buffer[4096];
+    for (ssize_t count; (count = read(connection, buffer, sizeof(buffer))) > 0; )
+        reply.append(buffer, count);
+    close(connection);
+
+    size_t newline = reply.find('\n');
+    if (reply.compare(0, 6, "error ") == 0)
+        throw reply.substr(6, newline - 6);
+
+    size_t space = reply.find(' ', 3);
+    if (reply.compare(0, 3, "ok ") != 0 || newline == string::npos || space > newline ||
+        reply.size() - newline - 1 != stoul(reply.substr(3, space - 3)))
+        throw "The server at " + path + " sent an incomplete reply.";
+
+    ofstream out(output);
+    if (!out)
+        throw "Can't write " + output + ".";
+    out << reply.substr(newline + 1);
+    return reply.substr(space + 1, newline - space - 1);
+}
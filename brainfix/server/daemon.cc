@@ -0,0 +1,159 @@
+#include "server.ih"
+
+size_t const Daemon::MAX_REPLIES = 256;
+
+Daemon::Daemon(string const &path)
+:
+    d_path(path),
+    d_socket(socket(AF_UNIX, SOCK_STREAM, 0))
+{
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (d_socket == -1 || path.size() >= sizeof(address.sun_path))
+        throw "Can't create a socket at " + path + ".";
+    strcpy(address.sun_path, path.c_str());
+    signal(SIGPIPE, SIG_IGN);       // a client that went away is not fatal
+
+    unlink(path.c_str());          // left behind by an earlier server
+    if (bind(d_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(d_socket, 16) != 0)
+    {
+        close(d_socket);
+        throw "Can't listen at " + path + ": " + strerror(errno) + ".";
+    }
+}
+
+Daemon::~Daemon()
+{
+    close(d_socket);
+    unlink(d_path.c_str());
+}
+
+    // Every client gets its own thread: compiles don't share any state but
+    // the caches
+void Daemon::run()
+{
+    while (true)
+    {
+        int connection = accept(d_socket, 0, 0);
+        if (connection == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            throw string("Can't accept connections: ") + strerror(errno) + ".";
+        }
+        thread(&Daemon::serve, this, connection).detach();
+    }
+}
+
+void Daemon::serve(int connection)
+{
+    string request;
+    char buffer[4096];
+    while (request.size() < 4 || request.compare(request.size() - 4, 4, "end\n") != 0)
+    {
+        ssize_t count = read(connection, buffer, sizeof(buffer));
+        if (count <= 0)
+        {
+            close(connection);
+            return;
+        }
+        request.append(buffer, count);
+    }
+
+    string response = reply(request);
+    for (size_t done = 0; done != response.size(); )
+    {
+        ssize_t count = write(connection, response.data() + done, response.size() - done);
+        if (count <= 0)
+            break;
+        done += count;
+    }
+    close(connection);
+}
+
+string Daemon::reply(string const &request)
+{
+    try
+    {
+        istringstream in(request);
+        Batch::Settings settings{Optimizer::Options(), Compiler::Target(), 30000, false, "bf"};
+        vector<string> inputs;
+        if (!readRequest(in, settings, inputs) || inputs.empty())
+            throw string("Incomplete request.");
+        if (settings.target.cellBits != 8 && settings.target.cellBits != 16 &&
+            settings.target.cellBits != 32)
+            throw string("Cells are 8, 16 or 32 bits wide.");
+        if (settings.backend != "bf" && settings.backend != "c" && settings.backend != "asm")
+            throw string("The target is bf, c or asm.");
+
+        // The same request gives the same output as long as its files are
+        // the same versions
+        string key = request;
+        vector<Preprocessor::Function> program;
+        for (string const &input: inputs)
+        {
+            string version;
+            vector<Preprocessor::Function> functions = this->functions(input, version);
+            program.insert(program.end(), functions.begin(), functions.end());
+            key += version;
+        }
+
+        {
+            lock_guard<mutex> lock(d_mutex);
+            auto cached = d_replies.find(key);
+            if (cached != d_replies.end())
+                return cached->second;
+        }
+
+        Compiler::Footprint footprint;
+        string output = Batch::compile(program, settings, footprint);
+        string response = "ok " + to_string(output.size()) + ' ' + Batch::usage(footprint) +
+                          '\n' + output;
+
+        lock_guard<mutex> lock(d_mutex);
+        if (d_replies.size() == MAX_REPLIES)
+            d_replies.clear();
+        d_replies[key] = response;
+        return response;
+    }
+    catch (string const &msg)
+    {
+        return "error " + msg + '\n';
+    }
+    catch (exception const &exc)
+    {
+        return string("error ") + exc.what() + '\n';
+    }
+}
+
+    // Preprocesses the file unless its text hasn't changed since the last
+    // time. Times of modification are too coarse: a file can change twice
+    // within a second.
+vector<Preprocessor::Function> Daemon::functions(string const &fileName, string &version)
+{
+    ifstream file(fileName, ios::binary);
+    if (!file)
+        throw "Can't open " + fileName + ".";
+    string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    unsigned long long hash = Optimizer::Cache::hash(text);
+    version = '\n' + fileName + ' ' + to_string(text.size()) + ' ' + to_string(hash);
+
+    {
+        lock_guard<mutex> lock(d_mutex);
+        auto cached = d_files.find(fileName);
+        if (cached != d_files.end() && cached->second.hash == hash)
+            return cached->second.functions;
+    }
+
+    istringstream in(text);
+    Preprocessor::Parser parser;
+    if (parser.parse(in, fileName) != 0)
+        throw "Can't preprocess " + fileName + ".";
+
+    lock_guard<mutex> lock(d_mutex);
+    d_files[fileName] = File{hash, parser.functions()};
+    return parser.functions();
+}
@@ -0,0 +1,61 @@
+#include "server.ih"
+
+void Server::writeRequest(ostream &out, Batch::Settings const &settings,
+                          vector<string> const &inputs)
+{
+    Optimizer::Options const &options = settings.options;
+    out << "unroll " << options.unrollBudget << '\n'
+        << "dce " << options.deadCode << '\n'
+        << "eval " << options.evaluate << '\n'
+        << "share " << options.shareBudget << '\n'
+        << "cache " << options.cache << '\n'
+        << "cell-bits " << settings.target.cellBits << '\n'
+        << "wrap " << settings.target.wrap << '\n'
+        << "tape-size " << settings.tapeSize << '\n'
+        << "header " << settings.header << '\n'
+        << "target " << settings.backend << '\n';
+    for (string const &input: inputs)
+        out << "input " << input << '\n';
+    out << "end\n";
+}
+
+    // Unknown keys are ignored, so older clients keep working
+bool Server::readRequest(istream &in, Batch::Settings &settings, vector<string> &inputs)
+{
+    Optimizer::Options &options = settings.options;
+    string line;
+    while (getline(in, line))
+    {
+        if (line == "end")
+            return true;
+
+        size_t space = line.find(' ');
+        string key = line.substr(0, space);
+        string value = space == string::npos ? "" : line.substr(space + 1);
+        istringstream number(value);
+
+        if (key == "input")
+            inputs.push_back(value);
+        else if (key == "target")
+            settings.backend = value;
+        else if (key == "cache")
+            options.cache = value;
+        else if (key == "unroll")
+            number >> options.unrollBudget;
+        else if (key == "dce")
+            number >> options.deadCode;
+        else if (key == "eval")
+            number >> options.evaluate;
+        else if (key == "share")
+            number >> options.shareBudget;
+        else if (key == "cell-bits")
+            number >> settings.target.cellBits;
+        else if (key == "wrap")
+            number >> settings.target.wrap;
+        else if (key == "tape-size")
+            number >> settings.tapeSize;
+        else if (key == "header")
+            number >> settings.header;
+    }
+    return false;
+}
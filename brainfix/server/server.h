@@ -0,0 +1,60 @@
+#ifndef Server_h_included
+#define Server_h_included
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <iosfwd>
+#include "../batch/batch.h"
+
+namespace Server
+{
+
+    // A request holds a line "<key> <value>" for every setting and input
+    // file, and ends with a line "end". The reply is a line "ok <size>
+    // <tape usage>" followed by the output file's text, or "error <message>".
+void writeRequest(std::ostream &out, Batch::Settings const &settings,
+                  std::vector<std::string> const &inputs);
+bool readRequest(std::istream &in, Batch::Settings &settings,
+                 std::vector<std::string> &inputs);    // false if it's incomplete
+
+    // Compiles the programs of any number of clients: the preprocessed
+    // files and the outputs of earlier requests are kept as long as the
+    // files don't change.
+class Daemon
+{
+    struct File
+    {
+        unsigned long long                  hash;       // of its text
+        std::vector<Preprocessor::Function> functions;
+    };
+
+    std::string                         d_path;
+    int                                 d_socket;
+    std::mutex                          d_mutex;        // of the caches
+    std::map<std::string, File>         d_files;        // by path
+    std::map<std::string, std::string>  d_replies;      // by request and file versions
+
+    static size_t const MAX_REPLIES;
+
+    public:
+        explicit Daemon(std::string const &path);   // throws std::string
+        ~Daemon();
+        void run();                                 // until the process is stopped
+
+    private:
+        void serve(int connection);
+        std::string reply(std::string const &request);
+        std::vector<Preprocessor::Function> functions(std::string const &fileName,
+                                                      std::string &version);
+};
+
+    // Has the server at path compile the inputs and writes its reply to
+    // output. Returns the tape usage. Throws std::string.
+std::string client(std::string const &path, Batch::Settings const &settings,
+            std::vector<std::string> const &inputs, std::string const &output);
+
+}
+
+#endif